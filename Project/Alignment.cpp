@@ -0,0 +1,376 @@
+#include "Alignment.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+HorizontalAlignment::HorizontalAlignment(const std::vector<osg::Vec3>& vertices) {
+    // 去除重合顶点，累计各段长度
+    for(const auto& v : vertices) {
+        if(!points.empty() && (v - points.back()).length2() <= 0.0f) continue;
+        chainages.push_back(points.empty() ? 0.0f : chainages.back() + (v - points.back()).length());
+        points.push_back(v);
+    }
+    buildSegmentIndex();
+}
+
+// 每桶线段数、每组桶数
+static const size_t kBucketSize = 16;
+
+// 点到线段的平面距离平方与线段参数
+static inline float segmentDistance2(float ax, float ay, float dx, float dy, float invLen2,
+                                     float x, float y, float& t) {
+    const float px = x - ax, py = y - ay;
+    t = std::min(std::max((px * dx + py * dy) * invLen2, 0.0f), 1.0f);
+    const float rx = px - dx * t, ry = py - dy * t;
+    return rx * rx + ry * ry;
+}
+
+// 线段分桶索引：相邻线段按顺序每kBucketSize条一桶，每kBucketSize桶一组，各记包围胶囊体
+// 平滑线形上一桶线段几乎与其弦重合，胶囊体半径很小，到弦的距离即为紧致的距离下界
+void HorizontalAlignment::buildSegmentIndex() {
+    segments.clear();
+    buckets.clear();
+    groups.clear();
+    if(!isValid()) return;
+    
+    auto makeSegment = [](const osg::Vec3& a, const osg::Vec3& b) {
+        Segment segment;
+        segment.ax = a.x();
+        segment.ay = a.y();
+        segment.dx = b.x() - a.x();
+        segment.dy = b.y() - a.y();
+        const float len2 = segment.dx * segment.dx + segment.dy * segment.dy;
+        segment.invLen2 = len2 > 0 ? 1.0f / len2 : 0.0f;
+        segment.invLen = len2 > 0 ? 1.0f / sqrtf(len2) : 0.0f;
+        return segment;
+    };
+    // 顶点first..last的包围胶囊体（线段上各点到弦的距离不超过两端点的距离）
+    auto makeCapsule = [&](size_t first, size_t last) {
+        Capsule capsule;
+        capsule.chord = makeSegment(points[first], points[last]);
+        float radius2 = 0.0f;
+        for(size_t k=first+1; k<last; ++k) {
+            float t;
+            radius2 = std::max(radius2, segmentDistance2(capsule.chord.ax, capsule.chord.ay, capsule.chord.dx,
+                                                         capsule.chord.dy, capsule.chord.invLen2,
+                                                         points[k].x(), points[k].y(), t));
+        }
+        capsule.radius = sqrtf(radius2);
+        return capsule;
+    };
+    
+    const size_t count = points.size() - 1;
+    segments.resize(count);
+    for(size_t k=0; k<count; ++k) {
+        segments[k] = makeSegment(points[k], points[k+1]);
+    }
+    for(size_t k=0; k<count; k+=kBucketSize) {
+        buckets.push_back(makeCapsule(k, std::min(k + kBucketSize, count)));
+    }
+    const size_t groupSegments = kBucketSize * kBucketSize;
+    for(size_t k=0; k<count; k+=groupSegments) {
+        groups.push_back(makeCapsule(k, std::min(k + groupSegments, count)));
+    }
+}
+
+// 直线线形
+HorizontalAlignment HorizontalAlignment::straight(const osg::Vec3& start, const osg::Vec3& direction, float length) {
+    osg::Vec3 d = direction;
+    d.normalize();
+    return HorizontalAlignment(std::vector<osg::Vec3>{ start, start + d * length });
+}
+
+// 桩号所在线段（二分查找，超出范围时取首末段）
+size_t HorizontalAlignment::segmentAt(float chainage) const {
+    size_t i = std::upper_bound(chainages.begin(), chainages.end(), chainage) - chainages.begin();
+    return std::min(std::max<size_t>(i, 1), points.size() - 1) - 1;
+}
+
+// 桩号对应的中线位置
+osg::Vec3 HorizontalAlignment::position(float chainage) const {
+    if(!isValid()) return points.empty() ? osg::Vec3() : points.front();
+    size_t i = segmentAt(chainage);
+    float t = (chainage - chainages[i]) / (chainages[i+1] - chainages[i]);
+    return points[i] + (points[i+1] - points[i]) * osg::clampBetween(t, 0.0f, 1.0f);
+}
+
+// 桩号处的单位切向
+osg::Vec3 HorizontalAlignment::tangent(float chainage) const {
+    if(!isValid()) return osg::Vec3(1, 0, 0);
+    size_t i = segmentAt(chainage);
+    osg::Vec3 d = points[i+1] - points[i];
+    d.normalize();
+    return d;
+}
+
+VerticalAlignment::VerticalAlignment(std::vector<VerticalPoint> points) {
+    std::sort(points.begin(), points.end(),
+        [](const VerticalPoint& a, const VerticalPoint& b) { return a.chainage < b.chainage; });
+    if(points.empty()) return;
+    if(points.size() == 1) {
+        addPiece(points[0].chainage, points[0].elevation, 0.0f, 0.0f);
+        return;
+    }
+    
+    // 相邻变坡点间的坡度
+    std::vector<float> grades(points.size() - 1);
+    for(size_t i=0; i+1<points.size(); ++i) {
+        float run = points[i+1].chainage - points[i].chainage;
+        grades[i] = run > 0 ? (points[i+1].elevation - points[i].elevation) / run : 0.0f;
+    }
+    
+    // 依次展开：坡段 -> 竖曲线 -> 坡段 ...，竖曲线半长不超过相邻坡段的一半以免重叠
+    float start = points[0].chainage;
+    float z = points[0].elevation;
+    for(size_t i=1; i+1<points.size(); ++i) {
+        const VerticalPoint& pvi = points[i];
+        float half = std::min(pvi.curveLength * 0.5f,
+                              0.5f * std::min(pvi.chainage - points[i-1].chainage, points[i+1].chainage - pvi.chainage));
+        half = std::max(half, 0.0f);
+        float bvc = pvi.chainage - half;
+        if(bvc > start || breakpoints.empty()) {
+            addPiece(start, z, grades[i-1], 0.0f);
+        }
+        if(half > 0) {
+            // 抛物线：z = z(BVC) + g1*t + (g2 - g1)/(2L)*t^2
+            addPiece(bvc, pvi.elevation - grades[i-1] * half, grades[i-1], (grades[i] - grades[i-1]) / (4 * half));
+        }
+        start = pvi.chainage + half;
+        z = pvi.elevation + grades[i] * half;
+    }
+    addPiece(start, z, grades.back(), 0.0f);
+}
+
+// 恒定高程的水平坡度线
+VerticalAlignment VerticalAlignment::constant(float elevation) {
+    return VerticalAlignment(std::vector<VerticalPoint>{ { 0.0f, elevation, 0.0f } });
+}
+
+void VerticalAlignment::addPiece(float start, float z, float g, float c) {
+    breakpoints.push_back(start);
+    c0.push_back(z);
+    c1.push_back(g);
+    c2.push_back(c);
+}
+
+// 桩号所在分段（首末分段向两端延伸）
+size_t VerticalAlignment::pieceAt(float chainage) const {
+    size_t i = std::upper_bound(breakpoints.begin(), breakpoints.end(), chainage) - breakpoints.begin();
+    return i > 0 ? i - 1 : 0;
+}
+
+// 设计高程
+float VerticalAlignment::elevation(float chainage) const {
+    if(!isValid()) return 0.0f;
+    size_t i = pieceAt(chainage);
+    float t = chainage - breakpoints[i];
+    return c0[i] + t * (c1[i] + t * c2[i]);
+}
+
+// 设计坡度
+float VerticalAlignment::grade(float chainage) const {
+    if(!isValid()) return 0.0f;
+    size_t i = pieceAt(chainage);
+    return c1[i] + 2 * c2[i] * (chainage - breakpoints[i]);
+}
+
+// 坡度变化率（竖曲线上为常数，坡段上为0）
+float VerticalAlignment::gradeChangeRate(float chainage) const {
+    return isValid() ? 2 * c2[pieceAt(chainage)] : 0.0f;
+}
+
+// 批量求设计高程：桩号递增时从上一分段顺序前进一步，否则回退到二分查找
+void VerticalAlignment::evaluate(const float* chainages, float* out, size_t count) const {
+    if(!isValid()) {
+        std::fill(out, out + count, 0.0f);
+        return;
+    }
+    const size_t pieces = breakpoints.size();
+    size_t i = pieceAt(count > 0 ? chainages[0] : 0.0f);
+    for(size_t k=0; k<count; ++k) {
+        float s = chainages[k];
+        if((i > 0 && s < breakpoints[i]) || (i + 2 < pieces && s >= breakpoints[i+2])) {
+            i = pieceAt(s);
+        } else if(i + 1 < pieces && s >= breakpoints[i+1]) {
+            ++i;
+        }
+        float t = s - breakpoints[i];
+        out[k] = c0[i] + t * (c1[i] + t * c2[i]);
+    }
+}
+
+// 左侧水平横向：折线顶点处取角平分方向并按斜接长度缩放，使两侧偏移线在顶点处连续
+osg::Vec3 HorizontalAlignment::lateral(float chainage) const {
+    osg::Vec3 d = tangent(chainage);
+    osg::Vec3 side(-d.y(), d.x(), 0);
+    side.normalize();
+    size_t i = isValid() ? segmentAt(chainage) : 0;
+    if(i > 0 && chainage == chainages[i]) {
+        osg::Vec3 in = points[i] - points[i-1];
+        in.normalize();
+        osg::Vec3 bisector(-(in.y() + d.y()), in.x() + d.x(), 0);
+        float cosHalf = bisector.normalize() > 0 ? bisector * side : 0.0f;
+        if(cosHalf > 0.1f) return bisector / cosHalf;
+    }
+    return side;
+}
+
+// 平面投影：返回点到中线最近点的桩号，offset 为相对该线段的有符号横向距离（左侧为正）
+float HorizontalAlignment::project(const osg::Vec3& point, float& offset) const {
+    float chainage;
+    const float x = point.x(), y = point.y();
+    project(&x, &y, &chainage, &offset, 1);
+    return chainage;
+}
+
+// 最近线段（距离相等时取编号最小者，与逐段遍历结果一致）
+// 以hint线段的距离为初始上界，逐组、逐桶按包围胶囊体距离剪枝
+size_t HorizontalAlignment::nearestSegment(float x, float y, size_t hint) const {
+    float t;
+    size_t bestSegment = hint;
+    float best = segmentDistance2(segments[hint].ax, segments[hint].ay, segments[hint].dx, segments[hint].dy,
+                                  segments[hint].invLen2, x, y, t);
+    float bestDistance = sqrtf(best);
+    
+    // 到弦的距离超过 半径+当前最近距离 时，胶囊体内不可能有更近的线段
+    auto outside = [&](const Capsule& capsule) {
+        const Segment& c = capsule.chord;
+        const float reach = capsule.radius + bestDistance;
+        return segmentDistance2(c.ax, c.ay, c.dx, c.dy, c.invLen2, x, y, t) > reach * reach;
+    };
+    for(size_t g=0; g<groups.size(); ++g) {
+        if(outside(groups[g])) continue;
+        const size_t bucketEnd = std::min((g + 1) * kBucketSize, buckets.size());
+        for(size_t b=g*kBucketSize; b<bucketEnd; ++b) {
+            if(outside(buckets[b])) continue;
+            const size_t segmentEnd = std::min((b + 1) * kBucketSize, segments.size());
+            for(size_t k=b*kBucketSize; k<segmentEnd; ++k) {
+                const Segment& s = segments[k];
+                const float dist2 = segmentDistance2(s.ax, s.ay, s.dx, s.dy, s.invLen2, x, y, t);
+                if(dist2 < best || (dist2 == best && k < bestSegment)) {
+                    best = dist2;
+                    bestDistance = sqrtf(best);
+                    bestSegment = k;
+                }
+            }
+        }
+    }
+    return bestSegment;
+}
+
+// 批量平面投影
+// 线段不多于一桶时外层遍历线段、内层遍历点，内层无分支依赖便于编译器向量化；
+// 线段较多时逐点经分桶索引求最近线段，并以前一点的最近线段作为初始上界（同行相邻点最近线段通常相同）
+void HorizontalAlignment::project(const float* xs, const float* ys, float* chainageOut, float* offsetOut,
+                                  size_t count) const {
+    std::fill(chainageOut, chainageOut + count, 0.0f);
+    std::fill(offsetOut, offsetOut + count, 0.0f);
+    if(!isValid()) return;
+    
+    if(segments.size() <= kBucketSize) {
+        std::vector<float> best(count, FLT_MAX);
+        for(size_t k=0; k<segments.size(); ++k) {
+            const Segment& s = segments[k];
+            const float start = chainages[k], span = chainages[k+1] - chainages[k];
+            for(size_t i=0; i<count; ++i) {
+                float t;
+                const float dist2 = segmentDistance2(s.ax, s.ay, s.dx, s.dy, s.invLen2, xs[i], ys[i], t);
+                const float rx = xs[i] - s.ax - s.dx * t, ry = ys[i] - s.ay - s.dy * t;
+                const bool closer = dist2 < best[i];
+                best[i] = closer ? dist2 : best[i];
+                chainageOut[i] = closer ? start + t * span : chainageOut[i];
+                offsetOut[i] = closer ? (s.dx * ry - s.dy * rx) * s.invLen : offsetOut[i];
+            }
+        }
+        return;
+    }
+    
+    size_t hint = 0;
+    for(size_t i=0; i<count; ++i) {
+        const size_t k = nearestSegment(xs[i], ys[i], hint);
+        const Segment& s = segments[k];
+        float t;
+        segmentDistance2(s.ax, s.ay, s.dx, s.dy, s.invLen2, xs[i], ys[i], t);
+        const float rx = xs[i] - s.ax - s.dx * t, ry = ys[i] - s.ay - s.dy * t;
+        chainageOut[i] = chainages[k] + t * (chainages[k+1] - chainages[k]);
+        offsetOut[i] = (s.dx * ry - s.dy * rx) * s.invLen;
+        hint = k;
+    }
+}
+
+// 沿线路走廊采样地面高程
+CorridorProfile sampleCorridorProfile(const Terrain* terrain, const HorizontalAlignment& alignment,
+                                      const CorridorParameters& corridor, TerrainInterpolation mode) {
+    CorridorProfile profile;
+    if(!alignment.isValid() || corridor.stationInterval <= 0) return profile;
+
+    // 桩号序列（末桩落在线路终点）
+    const float length = alignment.length();
+    size_t stations = static_cast<size_t>(length / corridor.stationInterval) + 1;
+    if((stations - 1) * corridor.stationInterval < length) ++stations;
+    profile.chainage.resize(stations);
+    for(size_t i=0; i<stations; ++i) {
+        profile.chainage[i] = std::min(i * corridor.stationInterval, length);
+    }
+
+    // 横向采样偏移，末位为中线
+    const int lateral = std::max(1, corridor.lateralSamples);
+    const size_t stride = lateral + 1;
+    std::vector<float> offsets(stride, 0.0f);
+    for(int k=0; k<lateral && lateral > 1; ++k) {
+        offsets[k] = corridor.corridorWidth * (k / float(lateral - 1) - 0.5f);
+    }
+
+    // 顺序走过各线段生成全部采样点，避免逐桩二分查找
+    const std::vector<osg::Vec3>& vertices = alignment.vertices();
+    std::vector<float> xs(stations * stride), ys(stations * stride), zs(stations * stride);
+    size_t segment = 0;
+    float segmentStart = 0.0f;
+    for(size_t i=0; i<stations; ++i) {
+        float s = profile.chainage[i];
+        float segmentLength = (vertices[segment+1] - vertices[segment]).length();
+        while(segment + 2 < vertices.size() && s > segmentStart + segmentLength) {
+            segmentStart += segmentLength;
+            ++segment;
+            segmentLength = (vertices[segment+1] - vertices[segment]).length();
+        }
+        osg::Vec3 d = (vertices[segment+1] - vertices[segment]) / segmentLength;
+        osg::Vec3 p = vertices[segment] + d * std::min(s - segmentStart, segmentLength);
+        osg::Vec3 side(-d.y(), d.x(), 0);
+        side.normalize();
+        for(size_t k=0; k<stride; ++k) {
+            xs[i*stride + k] = p.x() + side.x() * offsets[k];
+            ys[i*stride + k] = p.y() + side.y() * offsets[k];
+        }
+    }
+    TerrainSampler(terrain, mode).sample(xs.data(), ys.data(), zs.data(), xs.size());
+
+    // 逐桩统计走廊内高程范围
+    profile.centre.resize(stations);
+    profile.groundMin.resize(stations);
+    profile.groundMax.resize(stations);
+    for(size_t i=0; i<stations; ++i) {
+        const float* z = &zs[i*stride];
+        profile.groundMin[i] = *std::min_element(z, z + lateral);
+        profile.groundMax[i] = *std::max_element(z, z + lateral);
+        profile.centre[i].set(xs[i*stride + lateral], ys[i*stride + lateral], z[lateral]);
+    }
+    return profile;
+}
+
+// 提取连续成立的桩号区间
+std::vector<ProfileInterval> findProfileIntervals(const CorridorProfile& profile,
+                                                  const std::function<bool(size_t station)>& inside) {
+    std::vector<ProfileInterval> intervals;
+    bool open = false;
+    for(size_t i=0; i<profile.size(); ++i) {
+        if(inside(i)) {
+            if(!open) intervals.push_back({ profile.chainage[i], profile.chainage[i] });
+            intervals.back().chainageEnd = profile.chainage[i];
+            open = true;
+        } else {
+            open = false;
+        }
+    }
+    return intervals;
+}
\ No newline at end of file
@@ -0,0 +1,119 @@
+#pragma once
+#include "Terrain.h"
+#include "TerrainSampler.h"
+#include <osg/Vec3>
+#include <functional>
+#include <vector>
+
+// 平面线形：折线中线，按累计里程（桩号）参数化
+class HorizontalAlignment {
+public:
+    HorizontalAlignment() {}
+    explicit HorizontalAlignment(const std::vector<osg::Vec3>& vertices);
+    static HorizontalAlignment straight(const osg::Vec3& start, const osg::Vec3& direction, float length);
+
+    bool isValid() const { return points.size() >= 2; }
+    float length() const { return chainages.empty() ? 0.0f : chainages.back(); }
+    const std::vector<osg::Vec3>& vertices() const { return points; }
+    const std::vector<float>& vertexChainages() const { return chainages; }
+
+    osg::Vec3 position(float chainage) const;
+    osg::Vec3 tangent(float chainage) const;
+    osg::Vec3 lateral(float chainage) const;
+    float project(const osg::Vec3& point, float& offset) const;
+    void project(const float* xs, const float* ys, float* chainageOut, float* offsetOut, size_t count) const;
+
+private:
+    // 线段投影参数（构造时预计算）
+    struct Segment {
+        float ax, ay;           // 起点
+        float dx, dy;           // 方向（未归一化）
+        float invLen2, invLen;  // 平面长度平方与长度的倒数（零长度为0）
+    };
+    // 相邻线段的包围胶囊体：首末顶点连线（弦）及各顶点到弦的最大距离
+    struct Capsule {
+        Segment chord;
+        float radius;
+    };
+
+    size_t segmentAt(float chainage) const;
+    void buildSegmentIndex();
+    size_t nearestSegment(float x, float y, size_t hint) const;
+
+    std::vector<osg::Vec3> points;   // 中线顶点
+    std::vector<float> chainages;    // 各顶点累计里程
+    std::vector<Segment> segments;   // 各线段投影参数
+    std::vector<Capsule> buckets;    // 每桶相邻若干线段的包围胶囊体
+    std::vector<Capsule> groups;     // 每组相邻若干桶的包围胶囊体
+};
+
+// 变坡点
+struct VerticalPoint {
+    float chainage;      // 桩号
+    float elevation;     // 设计高程
+    float curveLength;   // 竖曲线长度（0 表示折线变坡）
+};
+
+// 纵断面线形（设计坡度线）：坡段与二次抛物线凸/凹竖曲线，按桩号求设计高程
+// 各坡段、竖曲线预先展开为按起点桩号排序的多项式分段，查询时二分定位分段
+class VerticalAlignment {
+public:
+    VerticalAlignment() {}
+    explicit VerticalAlignment(std::vector<VerticalPoint> points);
+    static VerticalAlignment constant(float elevation);
+
+    bool isValid() const { return !breakpoints.empty(); }
+    const std::vector<float>& breakChainages() const { return breakpoints; }
+    float elevation(float chainage) const;
+    float grade(float chainage) const;
+    float gradeChangeRate(float chainage) const;
+    void evaluate(const float* chainages, float* out, size_t count) const;
+
+private:
+    size_t pieceAt(float chainage) const;
+    void addPiece(float start, float z, float g, float c);
+
+    // 分段 i：z = c0 + c1*t + c2*t^2，t = 桩号 - breakpoints[i]
+    std::vector<float> breakpoints;
+    std::vector<float> c0, c1, c2;
+};
+
+// 构造物识别方式
+enum StructureDetectionMode {
+    DETECT_CORRIDOR_PROFILE = 0,     // 沿线路走廊纵断面采样，代价与线路长度成正比
+    DETECT_TERRAIN_REGIONS           // 走廊内地形连通区域标记，代价与走廊覆盖的瓦片面积成正比
+};
+
+// 走廊纵断面采样参数
+struct CorridorParameters {
+    float stationInterval;   // 桩距
+    float corridorWidth;     // 走廊宽度（中线两侧各一半）
+    int lateralSamples;      // 每个桩号的横向采样点数
+};
+
+// 走廊纵断面：每个桩号记录中线位置与走廊内地面高程范围
+struct CorridorProfile {
+    std::vector<float> chainage;       // 桩号
+    std::vector<osg::Vec3> centre;     // 中线地面点
+    std::vector<float> groundMin;      // 走廊内最低地面高程
+    std::vector<float> groundMax;      // 走廊内最高地面高程
+
+    size_t size() const { return chainage.size(); }
+};
+
+// 纵断面区间（桩号闭区间）
+struct ProfileInterval {
+    float chainageStart;
+    float chainageEnd;
+
+    float length() const { return chainageEnd - chainageStart; }
+};
+
+// 沿线路走廊采样地面高程，全部采样点一次批量插值
+CorridorProfile sampleCorridorProfile(const Terrain* terrain, const HorizontalAlignment& alignment,
+                                      const CorridorParameters& corridor,
+                                      TerrainInterpolation mode = INTERPOLATE_BILINEAR);
+
+// 单次顺序扫描，提取判定函数连续成立的桩号区间
+std::vector<ProfileInterval> findProfileIntervals(const CorridorProfile& profile,
+                                                  const std::function<bool(size_t station)>& inside);
\ No newline at end of file
@@ -0,0 +1,133 @@
+// 无界面批量建模命令行工具
+// 用法：BatchModeler --model curve|bridge|tunnel|slope [--input roads.shp] [--dem terrain.dem]
+//                    [--output dir] [--format osgb|ive] [--threads N] [--repeat N] [--width W]
+#include "CurveModel.h"
+#include "BridgeModel.h"
+#include "TunnelModel.h"
+#include "SlopeModel.h"
+#include "ShapefileReader.h"
+#include "Terrain.h"
+#include "TextureCache.h"
+#include "Parallel.h"
+#include <osgDB/WriteFile>
+#include <QDir>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+// 命令行选项
+struct BatchOptions {
+    std::string model = "curve";
+    std::string input;
+    std::string dem;
+    std::string output = ".";
+    std::string format = "osgb";
+    int threads = 0;
+    int repeat = 1;
+    float width = 2.0f;
+};
+
+static void printUsage() {
+    fprintf(stderr,
+        "用法: BatchModeler --model curve|bridge|tunnel|slope [--input roads.shp] [--dem terrain.dem]\n"
+        "                   [--output dir] [--format osgb|ive] [--threads N] [--repeat N] [--width W]\n");
+}
+
+static bool parseOptions(int argc, char** argv, BatchOptions& options) {
+    for(int i=1; i<argc; ++i) {
+        if(i + 1 >= argc) return false;
+        const char* key = argv[i];
+        const char* value = argv[++i];
+        if(strcmp(key, "--model") == 0) options.model = value;
+        else if(strcmp(key, "--input") == 0) options.input = value;
+        else if(strcmp(key, "--dem") == 0) options.dem = value;
+        else if(strcmp(key, "--output") == 0) options.output = value;
+        else if(strcmp(key, "--format") == 0) options.format = value;
+        else if(strcmp(key, "--threads") == 0) options.threads = atoi(value);
+        else if(strcmp(key, "--repeat") == 0) options.repeat = atoi(value);
+        else if(strcmp(key, "--width") == 0) options.width = static_cast<float>(atof(value));
+        else return false;
+    }
+    if(options.format != "osgb" && options.format != "ive") return false;
+    if(options.model == "curve") return !options.input.empty();
+    return options.model == "bridge" || options.model == "tunnel" || options.model == "slope";
+}
+
+// 执行单个建模任务并写出结果
+static bool runJob(const BatchOptions& options, const ShapefileReader& reader, Terrain* terrain, int job) {
+    osg::ref_ptr<osg::Group> scene;
+    if(options.model == "curve") {
+        PolylineView shape;
+        DbfRecordView attributes;
+        if(!reader.readRecord(job, shape, attributes) || !shape.isValid()) return true;
+
+        bool ok = false;
+        float width = attributes.toDouble(attributes.fieldIndex("width"), &ok);
+        CurvedRoadGenerator generator;
+        generator.generatePolyline(shape, ok && width > 0 ? width : options.width,
+                                   osg::Vec3(0, 0, 1), reader.bounds()._min);
+        scene = generator.getRoot();
+    } else if(options.model == "bridge") {
+        BridgeBuilder builder(terrain);
+        builder.run();
+        scene = builder.getRoot();
+    } else if(options.model == "tunnel") {
+        TunnelBuilder builder(terrain);
+        builder.run();
+        scene = builder.getRoot();
+    } else {
+        SlopeModeler modeler(terrain);
+        modeler.run();
+        scene = modeler.getRoot();
+    }
+
+    std::string fileName = options.output + "/" + options.model + "_" + std::to_string(job) + "." + options.format;
+    if(!osgDB::writeNodeFile(*scene, fileName)) {
+        fprintf(stderr, "写出失败: %s\n", fileName.c_str());
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    BatchOptions options;
+    if(!parseOptions(argc, argv, options)) {
+        printUsage();
+        return 1;
+    }
+
+    // 弯道路面按线要素分任务，其余模型按重复次数分任务
+    ShapefileReader reader;
+    int jobCount = options.repeat;
+    if(options.model == "curve") {
+        if(!reader.open(QString::fromLocal8Bit(options.input.c_str()))) {
+            fprintf(stderr, "%s\n", reader.errorString().toLocal8Bit().constData());
+            return 1;
+        }
+        jobCount = reader.recordCount();
+    }
+    QDir().mkpath(QString::fromLocal8Bit(options.output.c_str()));
+    TextureCache::instance().preloadAsync(); // 纹理在后台解码，所有任务共享
+
+    // 所有任务共享同一份按瓦片映射的地形
+    osg::ref_ptr<Terrain> terrain;
+    if(!options.dem.empty()) {
+        terrain = Terrain::openDem(QString::fromLocal8Bit(options.dem.c_str()));
+        if(!terrain) {
+            fprintf(stderr, "无法打开地形文件: %s\n", options.dem.c_str());
+            return 1;
+        }
+    }
+
+    // 任务在常驻线程池上并行执行，映射的只读数据在线程间共享；
+    // 各任务内部的并行循环在池线程中按串行执行，总线程数不超过设置值
+    std::atomic<int> failures(0);
+    parallelFor(jobCount, options.threads, [&](size_t job) {
+        if(!runJob(options, reader, terrain.get(), static_cast<int>(job))) ++failures;
+    });
+
+    fprintf(stdout, "完成 %d 个任务，失败 %d 个\n", jobCount, failures.load());
+    return failures > 0 ? 2 : 0;
+}
\ No newline at end of file
@@ -1,207 +1,408 @@
-#include "BridgeModeling.h"
+#include "BridgeModel.h"
 #include <osg/LineWidth>
-#include <osgDB/ReadFile>
-#include <QHBoxLayout>
+#include <osg/MatrixTransform>
+#include <osg/Program>
+#include <osg/TextureBuffer>
+#include <osg/Uniform>
+#include <QDebug>
+#include <algorithm>
+#include <cfloat>
 
 // 构造函数
-BridgeBuilder::BridgeBuilder(QWidget* parent) : QMainWindow(parent) {
+BridgeBuilder::BridgeBuilder(Terrain* sharedTerrain) : terrain(sharedTerrain) {
     // 初始化桥梁参数
     params = {
         5.0f,    // headLength
-        100.0f,  // headElevation
         8.0f,    // deckWidth
         0.5f,    // deckThickness
         1,       // deckTextureType
         10.0f,   // pierSpacing
         3.0f,    // pierBaseWidth
         8.0f,    // pierHeight
-        2        // pierTextureType
+        2,       // pierTextureType
+        0.02f    // crossSlope
     };
+    initializeScene();
+}
 
-    // 初始化Qt窗口
-    setGeometry(100, 100, 1200, 800);
-    QWidget* centralWidget = new QWidget(this);
-    QHBoxLayout* layout = new QHBoxLayout(centralWidget);
-    
-    // 初始化OSG场景
-    viewer = new osgViewer::Viewer();
+BridgeBuilder::BridgeBuilder(const BridgeParameters& parameters, Terrain* sharedTerrain)
+    : params(parameters), terrain(sharedTerrain) {
+    initializeScene();
+}
+
+// 初始化场景与地形
+void BridgeBuilder::initializeScene() {
     root = new osg::Group();
     terrainGeode = new osg::Geode();
     
-    // 加载地形数据（示例使用平面）
-    terrain.heightField = new osg::HeightField();
-    terrain.heightField->allocate(100, 100);
-    terrain.vertices = new osg::Vec3Array();
-    for(int x=0; x<100; ++x) {
-        for(int y=0; y<100; ++y) {
-            float z = 50 + 2*sin(x/10.0)*cos(y/10.0);
-            terrain.heightField->setHeight(x, y, z);
-            terrain.vertices->push_back(osg::Vec3(x, y, z));
-        }
+    // 每类部件一个分组，材质按分组统一设置
+    const char* componentNames[COMPONENT_COUNT] = { "deck", "pier", "railing", "abutment" };
+    for(int i=0; i<COMPONENT_COUNT; ++i) {
+        components[i] = new osg::Group();
+        components[i]->setName(componentNames[i]);
+        root->addChild(components[i]);
     }
     
-    // 执行算法流程
+    // 未提供共享地形时生成示例地形
+    if(!terrain) {
+        terrain = Terrain::createProcedural(100, 100, osg::Vec3(0, 0, 0), 1.0f, [](int x, int y) {
+            return static_cast<float>(50 + 2*sin(x/10.0)*cos(y/10.0));
+        });
+    }
+    
+    // 默认线路沿X轴穿过地形中部，走廊宽度取桥面宽度
+    float spacing = terrain->getSpacing();
+    osg::Vec3 start = terrain->getOrigin() + osg::Vec3(0, terrain->getNumRows() / 2 * spacing, 0);
+    float length = (terrain->getNumColumns() - 1) * spacing;
+    alignment = HorizontalAlignment::straight(start, osg::Vec3(1, 0, 0), length);
+    
+    // 默认坡度线沿线路取示例平面 z = 55 + 0.1x + 0.05y
+    float startZ = 55.0f + 0.1f*start.x() + 0.05f*start.y();
+    gradeline = VerticalAlignment({ { 0.0f, startZ, 0.0f }, { length, startZ + 0.1f*length, 0.0f } });
+    corridor = { 0.5f, params.deckWidth, 5 };
+    detectionMode = DETECT_CORRIDOR_PROFILE;
+    pierInstancing = true;
+}
+
+// 执行算法流程
+void BridgeBuilder::run() {
     computeLowLyingAreas();
     buildBridgeGeometry();
     applyTextures();
-    
-    // 设置场景数据
-    viewer->setSceneData(root);
-    viewer->realize();
 }
 
 // 步骤a: 计算低洼地带
 void BridgeBuilder::computeLowLyingAreas() {
     const float A = 20.0f; // 阈值长度
     
-    // 遍历地形网格
-    for(int x=0; x<100; ++x) {
-        for(int y=0; y<100; ++y) {
-            float terrainZ = terrain.heightField->getHeight(x, y);
-            float planZ = getPlanHeight(x, y);
-            
-            if(terrainZ < planZ) {
-                lowLyingPoints.push_back(osg::Vec3(x, y, terrainZ));
-            }
+    bridgeSpans.clear();
+    if(detectionMode == DETECT_CORRIDOR_PROFILE) {
+        // 只采样线路走廊，整个走廊地面低于设计坡度线时为低洼地段
+        CorridorProfile profile = sampleCorridorProfile(terrain.get(), alignment, corridor);
+        std::vector<float> design(profile.size());
+        gradeline.evaluate(profile.chainage.data(), design.data(), profile.size());
+        bridgeSpans = findProfileIntervals(profile, [&](size_t i) {
+            return profile.groundMax[i] < design[i];
+        });
+    } else {
+        // 走廊内连通区域标记，格点投影到线路得到桩号范围
+        std::vector<TerrainRegion> regions = labelTerrainRegions(terrain.get(),
+            [&](int, int, const osg::Vec3& vertex, float chainage) {
+                return vertex.z() < gradeline.elevation(chainage);
+            },
+            alignment, 0.5f * corridor.corridorWidth);
+        for(const auto& region : regions) {
+            bridgeSpans.push_back({ std::max(region.chainageMin, 0.0f), std::min(region.chainageMax, alignment.length()) });
         }
     }
     
-    // 聚类分析低洼区域（示例简化）
-    if(lowLyingPoints.size() > A) {
+    // 保留沿线路长度超过阈值的低洼区域
+    bridgeSpans.erase(std::remove_if(bridgeSpans.begin(), bridgeSpans.end(),
+        [A](const ProfileInterval& span) { return span.length() <= A; }), bridgeSpans.end());
+    for(const auto& span : bridgeSpans) {
         // 标记需要建设桥梁的区域
-        qDebug() << "需要建设桥梁，低洼区域长度：" << lowLyingPoints.size();
+        qDebug() << "需要建设桥梁，低洼区域长度：" << span.length();
     }
 }
 
-// 获取规划线路高度（示例使用线性插值）
-float BridgeBuilder::getPlanHeight(float x, float y) {
-    return 55.0f + 0.1*x + 0.05*y; // 示例线性函数
-}
-
-// 步骤b-d: 桥梁几何构建
+// 步骤b-d: 桥梁几何构建（每个低洼区域一座桥）
 void BridgeBuilder::buildBridgeGeometry() {
-    // 计算桥头位置
-    osg::Vec3 bridgeStart(20, 20, getPlanHeight(20, 20));
-    osg::Vec3 bridgeHead = computeBridgeHeadPosition(bridgeStart, params.headLength);
-    
-    // 创建桥面几何
-    createDeckGeometry();
-    
-    // 创建桥墩
-    const float C = 15.0f; // 桥墩阈值
-    if(bridgeDeckPoints.size() > C) {
-        int numPiers = ceil(bridgeDeckPoints.size() / params.pierSpacing);
-        for(int i=0; i<numPiers; ++i) {
-            osg::Vec3 position = bridgeDeckPoints[i * params.pierSpacing];
-            position.z() = params.headElevation - params.pierHeight;
-            createPierGeometry(position);
+    // 重复构建时清除上一次的桥墩与各部件几何
+    pierPositions.clear();
+    pierHeights.clear();
+    for(int i=0; i<COMPONENT_COUNT; ++i) {
+        components[i]->removeChildren(0, components[i]->getNumChildren());
+    }
+    
+    std::vector<float> pierChainages;
+    for(const auto& span : bridgeSpans) {
+        // 创建桥面几何：两端各延长桥头长度搭接路基，桥头标高随设计坡度线
+        createDeckGeometry(std::max(span.chainageStart - params.headLength, 0.0f),
+                           std::min(span.chainageEnd + params.headLength, alignment.length()));
+        
+        // 桥墩按桩号在两端桥台之间等分布置，间距不超过设计间距
+        const float C = 15.0f; // 桥墩阈值（桥长）
+        if(span.length() > C && params.pierSpacing > 0) {
+            int spans = static_cast<int>(ceil(span.length() / params.pierSpacing));
+            for(int i=1; i<spans; ++i) {
+                pierChainages.push_back(span.chainageStart + span.length() * i / spans);
+            }
         }
     }
+    
+    // 全部桥梁的桥墩一次批量求梁底高程与地面高程
+    size_t count = pierChainages.size();
+    std::vector<float> xs(count), ys(count), ground(count), deck(count);
+    for(size_t i=0; i<count; ++i) {
+        osg::Vec3 p = alignment.position(pierChainages[i]);
+        xs[i] = p.x();
+        ys[i] = p.y();
+    }
+    TerrainSampler(terrain.get()).sample(xs.data(), ys.data(), ground.data(), count);
+    gradeline.evaluate(pierChainages.data(), deck.data(), count);
+    
+    // 桥墩自地面延伸至梁底，梁底低于地面处不设墩
+    const float deckBottom = params.crossSlope * params.deckWidth / 2 + params.deckThickness;
+    for(size_t i=0; i<count; ++i) {
+        float height = deck[i] - deckBottom - ground[i];
+        if(height > 0) {
+            createPierGeometry(osg::Vec3(xs[i], ys[i], ground[i]), height);
+        }
+    }
+    
+    // 所有桥墩合并为一个共享网格节点
+    createPierInstances();
 }
 
-// 创建桥面几何
-void BridgeBuilder::createDeckGeometry() {
-    osg::Geometry* deckGeom = new osg::Geometry();
-    osg::Vec3Array* verts = new osg::Vec3Array();
+// 桥面细节层次：各级桩距与可见距离范围
+static const int kDeckLodLevels = 4;
+static const float kDeckLodSpacing[kDeckLodLevels] = { 0.5f, 2.0f, 8.0f, 32.0f };
+static const float kDeckLodRange[kDeckLodLevels + 1] = { 0.0f, 300.0f, 1000.0f, 3000.0f, FLT_MAX };
+
+// 区间内的扫掠桩号：等间距桩号并插入平纵线形的变化点
+static std::vector<float> deckStations(float chainageStart, float chainageEnd, float spacing,
+                                       const std::vector<float>& horizontalBreaks,
+                                       const std::vector<float>& verticalBreaks) {
+    std::vector<float> stations;
+    int count = static_cast<int>((chainageEnd - chainageStart) / spacing);
+    stations.reserve(count + 2 + horizontalBreaks.size() + verticalBreaks.size());
+    for(int i=0; i<=count; ++i) {
+        stations.push_back(chainageStart + i*spacing);
+    }
+    stations.push_back(chainageEnd);
+    for(const std::vector<float>* breaks : { &horizontalBreaks, &verticalBreaks }) {
+        for(float s : *breaks) {
+            if(s > chainageStart && s < chainageEnd) stations.push_back(s);
+        }
+    }
     
-    // 生成桥面顶点（示例简化）
-    for(int i=0; i<50; ++i) {
-        float x = 20 + i*0.5f;
-        float y = 20;
-        float z = params.headElevation;
-        verts->push_back(osg::Vec3(x, y, z));
-        verts->push_back(osg::Vec3(x, y+params.deckWidth, z));
+    // 排序并去除过近的桩号
+    std::sort(stations.begin(), stations.end());
+    size_t kept = 1;
+    for(size_t i=1; i<stations.size(); ++i) {
+        if(stations[i] - stations[kept-1] > 1e-3f) stations[kept++] = stations[i];
+    }
+    stations.resize(kept);
+    stations.back() = chainageEnd;
+    return stations;
+}
+
+// 创建桥面几何（沿平纵线形扫掠，预生成多级细节层次）
+void BridgeBuilder::createDeckGeometry(float chainageStart, float chainageEnd) {
+    osg::LOD* deckLod = new osg::LOD();
+    for(int level=0; level<kDeckLodLevels; ++level) {
+        std::vector<float> stations = deckStations(chainageStart, chainageEnd, kDeckLodSpacing[level],
+                                                   alignment.vertexChainages(), gradeline.breakChainages());
+        osg::Geode* deckGeode = new osg::Geode();
+        deckGeode->addDrawable(sweepDeck(stations));
+        deckLod->addChild(deckGeode, kDeckLodRange[level], kDeckLodRange[level+1]);
     }
+    components[DECK]->addChild(deckLod);
+}
+
+// 沿桩号扫掠桥面断面：顶面双向横坡、两侧面与底面，每个面一条带状索引三角带
+osg::Geometry* BridgeBuilder::sweepDeck(const std::vector<float>& stations) {
+    // 断面轮廓（向左横向偏移, 竖向偏移），逆时针排列，每个面由两个轮廓点构成
+    const float half = params.deckWidth / 2;
+    const float edgeDrop = params.crossSlope * half;
+    const float bottom = -edgeDrop - params.deckThickness;
+    const osg::Vec2 faces[5][2] = {
+        { osg::Vec2(half, -edgeDrop),   osg::Vec2(0, 0) },             // 顶面左半幅
+        { osg::Vec2(0, 0),              osg::Vec2(-half, -edgeDrop) }, // 顶面右半幅
+        { osg::Vec2(-half, -edgeDrop),  osg::Vec2(-half, bottom) },    // 右侧面
+        { osg::Vec2(-half, bottom),     osg::Vec2(half, bottom) },     // 底面
+        { osg::Vec2(half, bottom),      osg::Vec2(half, -edgeDrop) }   // 左侧面
+    };
     
-    deckGeom->setVertexArray(verts);
-    deckGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::QUAD_STRIP, 0, verts->size()));
+    const size_t count = stations.size();
+    osg::Geometry* geom = new osg::Geometry();
+    osg::Vec3Array* verts = new osg::Vec3Array();
+    osg::Vec3Array* norms = new osg::Vec3Array();
+    osg::Vec2Array* texCoords = new osg::Vec2Array();
+    verts->reserve(count * 10);
+    norms->reserve(count * 10);
+    texCoords->reserve(count * 10);
     
-    osg::Geode* deckGeode = new osg::Geode();
-    deckGeode->addDrawable(deckGeom);
-    root->addChild(deckGeode);
+    // 各桩号的中线点与横向，五个面共用
+    std::vector<osg::Vec3> centres(count), sides(count);
+    std::vector<float> elevations(count);
+    gradeline.evaluate(stations.data(), elevations.data(), count);
+    for(size_t i=0; i<count; ++i) {
+        centres[i] = alignment.position(stations[i]);
+        centres[i].z() = elevations[i];
+        sides[i] = alignment.lateral(stations[i]);
+    }
     
-    // 保存桥面点用于后续计算
-    for(size_t i=0; i<verts->size(); i+=2) {
-        bridgeDeckPoints.push_back((*verts)[i]);
+    for(const auto& face : faces) {
+        // 面法线在断面内垂直于轮廓边并朝外
+        osg::Vec2 edge = face[1] - face[0];
+        osg::Vec2 outward(edge.y(), -edge.x());
+        outward.normalize();
+        float width = edge.length();
+        
+        osg::DrawElementsUInt* strip = new osg::DrawElementsUInt(GL_TRIANGLE_STRIP);
+        strip->reserve(count * 2);
+        for(size_t i=0; i<count; ++i) {
+            osg::Vec3 lateral = sides[i];
+            lateral.normalize();
+            osg::Vec3 normal = lateral * outward.x() + osg::Vec3(0, 0, outward.y());
+            for(int k=0; k<2; ++k) {
+                strip->push_back(verts->size());
+                verts->push_back(centres[i] + sides[i] * face[k].x() + osg::Vec3(0, 0, face[k].y()));
+                norms->push_back(normal);
+                texCoords->push_back(osg::Vec2(k * width / params.deckWidth, stations[i] / params.deckWidth));
+            }
+        }
+        geom->addPrimitiveSet(strip);
     }
+    
+    geom->setVertexArray(verts);
+    geom->setNormalArray(norms, osg::Array::BIND_PER_VERTEX);
+    geom->setTexCoordArray(0, texCoords);
+    return geom;
+}
+
+// 记录桥墩实例（几何体在全部桥墩确定后统一创建）
+void BridgeBuilder::createPierGeometry(const osg::Vec3& position, float height) {
+    pierPositions.push_back(position);
+    pierHeights.push_back(height);
 }
 
-// 创建桥墩几何
-void BridgeBuilder::createPierGeometry(const osg::Vec3& position) {
-    osg::Geometry* pierGeom = new osg::Geometry();
+// 单位高度桥墩网格：底面中心位于原点，高度为1，四个侧面与顶面
+static osg::Geometry* createUnitPierMesh(float baseWidth) {
+    osg::Geometry* geom = new osg::Geometry();
     osg::Vec3Array* verts = new osg::Vec3Array();
+    osg::Vec3Array* norms = new osg::Vec3Array();
+    osg::Vec2Array* texCoords = new osg::Vec2Array();
+    osg::DrawElementsUInt* indices = new osg::DrawElementsUInt(GL_TRIANGLES);
     
-    // 创建桥墩底座
-    float half = params.pierBaseWidth / 2;
-    verts->push_back(position + osg::Vec3(-half, -half, 0));
-    verts->push_back(position + osg::Vec3( half, -half, 0));
-    verts->push_back(position + osg::Vec3( half,  half, 0));
-    verts->push_back(position + osg::Vec3(-half,  half, 0));
+    float half = baseWidth / 2;
+    const osg::Vec3 corners[4] = {
+        osg::Vec3(-half, -half, 0), osg::Vec3(half, -half, 0), osg::Vec3(half, half, 0), osg::Vec3(-half, half, 0)
+    };
     
-    // 创建桥墩柱体
+    // 侧面（每面独立顶点以保证法线正确）
     for(int i=0; i<4; ++i) {
-        verts->push_back((*verts)[i] + osg::Vec3(0,0,params.pierHeight));
+        const osg::Vec3& a = corners[i];
+        const osg::Vec3& b = corners[(i+1)%4];
+        osg::Vec3 normal = (b - a) ^ osg::Vec3(0, 0, 1);
+        normal.normalize();
+        unsigned int base = verts->size();
+        verts->push_back(a);
+        verts->push_back(b);
+        verts->push_back(b + osg::Vec3(0, 0, 1));
+        verts->push_back(a + osg::Vec3(0, 0, 1));
+        texCoords->push_back(osg::Vec2(0, 0));
+        texCoords->push_back(osg::Vec2(1, 0));
+        texCoords->push_back(osg::Vec2(1, 1));
+        texCoords->push_back(osg::Vec2(0, 1));
+        for(int k=0; k<4; ++k) norms->push_back(normal);
+        indices->push_back(base);     indices->push_back(base + 1); indices->push_back(base + 2);
+        indices->push_back(base);     indices->push_back(base + 2); indices->push_back(base + 3);
     }
     
-    pierGeom->setVertexArray(verts);
-    pierGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::QUADS, 0, 8));
-    
-    osg::Geode* pierGeode = new osg::Geode();
-    pierGeode->addDrawable(pierGeom);
-    root->addChild(pierGeode);
+    // 顶面
+    unsigned int base = verts->size();
+    for(int i=0; i<4; ++i) {
+        verts->push_back(corners[i] + osg::Vec3(0, 0, 1));
+        norms->push_back(osg::Vec3(0, 0, 1));
+        texCoords->push_back(osg::Vec2(i == 1 || i == 2 ? 1 : 0, i >= 2 ? 1 : 0));
+    }
+    indices->push_back(base);     indices->push_back(base + 1); indices->push_back(base + 2);
+    indices->push_back(base);     indices->push_back(base + 2); indices->push_back(base + 3);
     
-    // 保存桥墩位置
-    pierPositions.push_back(position);
+    geom->setVertexArray(verts);
+    geom->setNormalArray(norms, osg::Array::BIND_PER_VERTEX);
+    geom->setTexCoordArray(0, texCoords);
+    geom->addPrimitiveSet(indices);
+    return geom;
 }
 
-// 步骤e: 纹理贴图
-void BridgeBuilder::applyTextures() {
-    // 加载纹理
-    osg::Texture2D* deckTex = loadTexture(params.deckTextureType);
-    osg::Texture2D* pierTex = loadTexture(params.pierTextureType);
-    
-    // 遍历所有几何体应用纹理
-    for(auto& child : root->getChildren()) {
-        osg::Geode* geode = dynamic_cast<osg::Geode*>(child.get());
-        if(geode) {
-            for(auto& drawable : geode->getDrawables()) {
-                osg::Geometry* geom = drawable->asGeometry();
-                if(geom) {
-                    osg::StateSet* stateset = geom->getOrCreateStateSet();
-                    if(geom->getVertexArray()->getNumElements() > 100) {
-                        stateset->setTextureAttributeAndModes(0, deckTex, osg::StateAttribute::ON);
-                    } else {
-                        stateset->setTextureAttributeAndModes(0, pierTex, osg::StateAttribute::ON);
-                    }
-                }
-            }
+// 实例化顶点着色器：按实例号从缓冲纹理取桥墩位置(xyz)与高度(w)
+// 着色器替代了固定管线光照，按0号光源做逐顶点漫反射（单位网格各面轴向对齐，竖向缩放不改变法线）
+static const char* kPierVertexShader =
+    "#version 120\n"
+    "#extension GL_EXT_gpu_shader4 : enable\n"
+    "#extension GL_ARB_draw_instanced : enable\n"
+    "uniform samplerBuffer pierInstances;\n"
+    "void main() {\n"
+    "    vec4 pier = texelFetchBuffer(pierInstances, gl_InstanceIDARB);\n"
+    "    vec4 vertex = vec4(gl_Vertex.xy + pier.xy, pier.z + gl_Vertex.z * pier.w, 1.0);\n"
+    "    gl_Position = gl_ModelViewProjectionMatrix * vertex;\n"
+    "    gl_TexCoord[0] = gl_MultiTexCoord0;\n"
+    "    vec3 normal = normalize(gl_NormalMatrix * gl_Normal);\n"
+    "    vec4 light = gl_LightSource[0].position;\n"
+    "    vec3 lightDir = normalize(light.w == 0.0 ? light.xyz : light.xyz - (gl_ModelViewMatrix * vertex).xyz);\n"
+    "    float diffuse = max(dot(normal, lightDir), 0.0);\n"
+    "    vec3 lit = gl_LightModel.ambient.rgb + gl_LightSource[0].ambient.rgb + gl_LightSource[0].diffuse.rgb * diffuse;\n"
+    "    gl_FrontColor = vec4(gl_Color.rgb * clamp(lit, 0.0, 1.0), gl_Color.a);\n"
+    "}\n";
+
+// 创建桥墩节点：一个共享网格，实例数据放在单个缓冲纹理中；
+// 不使用实例化时退化为共享同一网格的轻量变换节点
+void BridgeBuilder::createPierInstances() {
+    if(pierPositions.empty()) return;
+    
+    osg::ref_ptr<osg::Geometry> pierMesh = createUnitPierMesh(params.pierBaseWidth);
+    osg::Geode* pierGeode = new osg::Geode();
+    pierGeode->addDrawable(pierMesh);
+    
+    if(!pierInstancing) {
+        osg::Group* piers = new osg::Group();
+        for(size_t i=0; i<pierPositions.size(); ++i) {
+            osg::MatrixTransform* transform = new osg::MatrixTransform(
+                osg::Matrix::scale(1, 1, pierHeights[i]) * osg::Matrix::translate(pierPositions[i]));
+            transform->addChild(pierGeode);
+            piers->addChild(transform);
         }
+        components[PIER]->addChild(piers);
+        return;
     }
+    
+    // 实例数据：每个桥墩16字节
+    osg::Vec4Array* instances = new osg::Vec4Array();
+    instances->reserve(pierPositions.size());
+    osg::BoundingBox bound;
+    float half = params.pierBaseWidth / 2;
+    for(size_t i=0; i<pierPositions.size(); ++i) {
+        const osg::Vec3& p = pierPositions[i];
+        instances->push_back(osg::Vec4(p, pierHeights[i]));
+        bound.expandBy(p - osg::Vec3(half, half, 0));
+        bound.expandBy(p + osg::Vec3(half, half, pierHeights[i]));
+    }
+    
+    osg::TextureBuffer* instanceBuffer = new osg::TextureBuffer();
+    instanceBuffer->setInternalFormat(GL_RGBA32F_ARB);
+    instanceBuffer->setBufferData(instances);
+    
+    // 网格本身只覆盖单个桥墩，需指定全部实例的包围盒以免被错误裁剪
+    pierMesh->getPrimitiveSet(0)->setNumInstances(pierPositions.size());
+    pierMesh->setInitialBound(bound);
+    pierMesh->setUseDisplayList(false);
+    pierMesh->setUseVertexBufferObjects(true);
+    
+    osg::Program* program = new osg::Program();
+    program->addShader(new osg::Shader(osg::Shader::VERTEX, kPierVertexShader));
+    osg::StateSet* stateset = pierGeode->getOrCreateStateSet();
+    stateset->setAttributeAndModes(program, osg::StateAttribute::ON);
+    stateset->setTextureAttribute(1, instanceBuffer);
+    stateset->addUniform(new osg::Uniform("pierInstances", 1));
+    components[PIER]->addChild(pierGeode);
 }
 
-// 加载纹理资源
-osg::Texture2D* BridgeBuilder::loadTexture(int type) {
-    osg::Texture2D* tex = new osg::Texture2D();
-    switch(type) {
-        case 1: tex->setImage(osgDB::readImageFile("concrete.jpg")); break;
-        case 2: tex->setImage(osgDB::readImageFile("stone.jpg")); break;
-        default: tex->setImage(osgDB::readImageFile("default.png"));
-    }
-    tex->setWrap(osg::Texture::WRAP_S, osg::Texture::REPEAT);
-    tex->setWrap(osg::Texture::WRAP_T, osg::Texture::REPEAT);
-    return tex;
-}
-
-// 计算桥头位置
-osg::Vec3 BridgeBuilder::computeBridgeHeadPosition(const osg::Vec3& start, float length) {
-    // 简化计算：沿X轴方向延长
-    return osg::Vec3(start.x() + length, start.y(), start.z());
+// 步骤e: 纹理贴图（按部件分组直接设置，无需遍历场景图）
+void BridgeBuilder::applyTextures() {
+    const int textureTypes[COMPONENT_COUNT] = { params.deckTextureType, params.pierTextureType, 0, 0 };
+    for(int i=0; i<COMPONENT_COUNT; ++i) {
+        components[i]->setStateSet(TextureCache::instance().getStateSet(materialOf(textureTypes[i])));
+    }
 }
 
-// Qt主函数
-int main(int argc, char** argv) {
-    QApplication app(argc, argv);
-    BridgeBuilder window;
-    window.show();
-    return app.exec();
+// 纹理类型参数对应的材质
+MaterialType BridgeBuilder::materialOf(int textureType) {
+    switch(textureType) {
+        case 1: return MATERIAL_CONCRETE;
+        case 2: return MATERIAL_STONE;
+        default: return MATERIAL_DEFAULT;
+    }
 }
\ No newline at end of file
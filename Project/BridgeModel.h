@@ -1,16 +1,19 @@
 #pragma once
 #include <osg/Geode>
 #include <osg/Geometry>
-#include <osgViewer/Viewer>
-#include <QMainWindow>
+#include <osg/LOD>
+#include "Terrain.h"
+#include "RegionLabeling.h"
+#include "Alignment.h"
+#include "TerrainSampler.h"
+#include "TextureCache.h"
 #include <vector>
 #include <cmath>
 
 // 桥梁参数结构体
 struct BridgeParameters {
     // 桥头参数
-    float headLength;           // 桥头延长长度
-    float headElevation;        // 桥头标高
+    float headLength;           // 桥头延长长度（桥面在低洼区间两端各延长）
     
     // 桥面参数
     float deckWidth;            // 桥面宽度
@@ -20,14 +23,11 @@ struct BridgeParameters {
     // 桥墩参数
     float pierSpacing;          // 桥墩间距
     float pierBaseWidth;        // 桥墩底座宽度
-    float pierHeight;           // 桥墩高度
+    float pierHeight;           // 桥墩高度（示例值，实际墩高由梁底与地面高程确定）
     int pierTextureType;        // 桥墩纹理类型
-};
-
-// 地形数据结构
-struct TerrainData {
-    osg::ref_ptr<osg::HeightField> heightField;
-    osg::Vec3Array* vertices;
+    
+    // 横坡参数（追加在末尾，不改变既有字段顺序）
+    float crossSlope;           // 桥面横坡（自中线向两侧下降，如0.02）
 };
 
 // 桥梁部件枚举
@@ -35,13 +35,23 @@ enum BridgeComponent {
     DECK = 0,
     PIER,
     RAILING,
-    ABUTMENT
+    ABUTMENT,
+    COMPONENT_COUNT
 };
 
-class BridgeBuilder : public QMainWindow {
-    Q_OBJECT
+// 桥梁建模引擎（不依赖窗口，可在无显示环境下运行）
+class BridgeBuilder {
 public:
-    BridgeBuilder(QWidget* parent = nullptr);
+    explicit BridgeBuilder(Terrain* sharedTerrain = nullptr);
+    BridgeBuilder(const BridgeParameters& parameters, Terrain* sharedTerrain = nullptr);
+    osg::Group* getRoot() const { return root.get(); }
+    osg::Group* getComponent(BridgeComponent component) const { return components[component].get(); }
+    void setAlignment(const HorizontalAlignment& route) { alignment = route; }
+    void setGradeline(const VerticalAlignment& profile) { gradeline = profile; }
+    void setCorridor(const CorridorParameters& parameters) { corridor = parameters; }
+    void setDetectionMode(StructureDetectionMode mode) { detectionMode = mode; }
+    void setPierInstancing(bool enabled) { pierInstancing = enabled; }
+    void run();
     void initializeScene();
     void computeLowLyingAreas();
     void buildBridgeGeometry();
@@ -49,22 +59,27 @@ public:
 
 private:
     // OSG场景组件
-    osg::ref_ptr<osgViewer::Viewer> viewer;
     osg::ref_ptr<osg::Group> root;
     osg::ref_ptr<osg::Geode> terrainGeode;
+    osg::ref_ptr<osg::Group> components[COMPONENT_COUNT];  // 按部件类型分组的几何体
     
     // 算法中间数据
     BridgeParameters params;
-    TerrainData terrain;
-    std::vector<osg::Vec3> lowLyingPoints;
-    std::vector<osg::Vec3> bridgeDeckPoints;
-    std::vector<osg::Vec3> pierPositions;
+    osg::ref_ptr<Terrain> terrain;
+    HorizontalAlignment alignment;
+    VerticalAlignment gradeline;                   // 设计坡度线
+    CorridorParameters corridor;
+    StructureDetectionMode detectionMode;
+    std::vector<ProfileInterval> bridgeSpans;      // 各桥梁桩号区间
+    std::vector<osg::Vec3> pierPositions;          // 桥墩底部中心
+    std::vector<float> pierHeights;                // 桥墩高度
+    bool pierInstancing;                           // 是否使用硬件实例化绘制桥墩
 
     // 辅助函数
-    float getPlanHeight(float x, float y);
     bool isLowLyingArea(float x, float y);
-    osg::Vec3 computeBridgeHeadPosition(const osg::Vec3& start, float length);
-    void createPierGeometry(const osg::Vec3& position);
-    void createDeckGeometry();
-    osg::Texture2D* loadTexture(int type);
+    void createPierGeometry(const osg::Vec3& position, float height);
+    void createPierInstances();
+    void createDeckGeometry(float chainageStart, float chainageEnd);
+    osg::Geometry* sweepDeck(const std::vector<float>& stations);
+    static MaterialType materialOf(int textureType);
 };
\ No newline at end of file
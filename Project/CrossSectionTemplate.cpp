@@ -0,0 +1,57 @@
+#include "CrossSectionTemplate.h"
+#include "SlopeModel.h"
+#include <osg/Math>
+#include <algorithm>
+#include <cmath>
+
+// 逐级坡面与平台，direction 为 1 时向上（挖方），-1 时向下（填方）
+static void addStages(std::vector<osg::Vec2>& points, const SlopeParameters& params, float slope,
+                      float direction, float extent) {
+    // 每级高度与平台宽度取值与分类规则一致：坡面水平投影等于平台宽度
+    const float run = std::max(params.platformWidth, 1e-3f);
+    const float rise = run * slope;
+    const int stages = std::max(params.stages, 1);
+    osg::Vec2 p = points.back();
+    for(int i=0; i<stages; ++i) {
+        p += osg::Vec2(run, direction * rise);
+        points.push_back(p);
+        if(i + 1 < stages) {
+            p += osg::Vec2(params.platformWidth, 0);
+            points.push_back(p);
+        }
+    }
+    
+    // 末级坡面延伸到范围边界
+    if(p.x() < extent) {
+        points.push_back(osg::Vec2(extent, p.y() + direction * (extent - p.x()) * slope));
+    }
+}
+
+CrossSectionTemplate CrossSectionTemplate::compile(const SlopeParameters& params, float extent) {
+    CrossSectionTemplate section;
+    const float slope = tanf(osg::DegreesToRadians(params.slopeAngle));
+    
+    // 挖方：梯形排水沟（深度取沟宽一半，底宽取沟宽三分之一）
+    const float ditch = params.ditchWidth;
+    section.cutPoints.push_back(osg::Vec2(0, 0));
+    if(ditch > 0) {
+        section.cutPoints.push_back(osg::Vec2(ditch / 3, -ditch / 2));
+        section.cutPoints.push_back(osg::Vec2(ditch * 2 / 3, -ditch / 2));
+        section.cutPoints.push_back(osg::Vec2(ditch, 0));
+    }
+    addStages(section.cutPoints, params, slope, 1.0f, extent);
+    
+    // 填方：自路基边缘直接放坡
+    section.fillPoints.push_back(osg::Vec2(0, 0));
+    addStages(section.fillPoints, params, slope, -1.0f, extent);
+    return section;
+}
+
+void CrossSectionTemplate::instance(bool fill, const osg::Vec3& origin, const osg::Vec3& lateral,
+                                    std::vector<osg::Vec3>& out) const {
+    const std::vector<osg::Vec2>& points = fill ? fillPoints : cutPoints;
+    out.resize(points.size());
+    for(size_t i=0; i<points.size(); ++i) {
+        out[i] = origin + lateral * points[i].x() + osg::Vec3(0, 0, points[i].y());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+#include <osg/Vec2>
+#include <osg/Vec3>
+#include <vector>
+
+struct SlopeParameters;
+
+// 边坡横断面模板：由边坡参数编译一次，得到挖方与填方两条折线
+// 局部坐标 x 为离开路基边缘的横向距离，y 为相对设计高程的高差
+// 挖方：排水沟 + 逐级上坡，级间设平台；填方：逐级下坡，级间设平台
+// 末级坡面沿原坡率延伸到横向范围边界，保证能与地形相交
+class CrossSectionTemplate {
+public:
+    CrossSectionTemplate() {}
+    static CrossSectionTemplate compile(const SlopeParameters& params, float extent);
+
+    size_t size(bool fill) const { return fill ? fillPoints.size() : cutPoints.size(); }
+    const std::vector<osg::Vec2>& getCut() const { return cutPoints; }
+    const std::vector<osg::Vec2>& getFill() const { return fillPoints; }
+
+    // 仿射实例化：origin + lateral * x + (0,0,1) * y，写入复用的缓冲区（只在容量不足时分配）
+    void instance(bool fill, const osg::Vec3& origin, const osg::Vec3& lateral, std::vector<osg::Vec3>& out) const;
+
+private:
+    std::vector<osg::Vec2> cutPoints;   // 挖方折线
+    std::vector<osg::Vec2> fillPoints;  // 填方折线
+};
\ No newline at end of file
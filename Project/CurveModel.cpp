@@ -1,140 +1,161 @@
-#include "CurvedRoadGenerator.h"
+#include "CurveModel.h"
+#include "ShapefileReader.h"
+#include "PolylineRoad.h"
+#include "RoadKernels.h"
 #include <osg/Geode>
-#include <osg/ShapeDrawable>
-#include <QHBoxLayout>
+#include <QDebug>
 #include <cmath>
 
 // 构造函数初始化
-CurvedRoadGenerator::CurvedRoadGenerator(QWidget* parent) : QMainWindow(parent) {
-    // Qt窗口设置
-    setGeometry(100, 100, 1200, 800);
-    QWidget* centralWidget = new QWidget(this);
-    QHBoxLayout* layout = new QHBoxLayout(centralWidget);
-    
-    // OSG场景初始化
-    viewer = new osgViewer::Viewer();
+CurvedRoadGenerator::CurvedRoadGenerator() {
     root = new osg::Group();
-    
-    // 示例参数
-    osg::Vec3 A(0, 0, 0);
-    osg::Vec3 B(10, 5, 0);
-    osg::Vec3 C(20, 0, 0);
-    float width = 2.0f;
-    osg::Vec3 normal(0, 0, 1);
-    
-    // 生成弯道路面
-    generateCurvedRoad(A, B, C, width, normal);
-    
-    // 设置场景数据
-    viewer->setSceneData(root);
-    viewer->realize();
 }
 
-// 主算法实现
+// 主算法实现（单个转角）
 void CurvedRoadGenerator::generateCurvedRoad(const osg::Vec3& A, const osg::Vec3& B, 
                                            const osg::Vec3& C, float width, 
                                            const osg::Vec3& normal) {
-    // 步骤1-2: 计算路径向量
-    osg::Vec3 Vab = B - A;
-    osg::Vec3 Vbc = C - B;
-
-    // 步骤3-8: 计算扩展点
-    osg::Vec3 V0 = computePerpendicularVector(Vab, normal) * width;
-    osg::Vec3 V1 = computePerpendicularVector(Vbc, normal) * width;
-    
-    osg::Vec3 Ax = A + V0;
-    osg::Vec3 ABx = B + V0;
-    osg::Vec3 BCx = B + V1;
-    osg::Vec3 Cx = C + V1;
-
-    // 可视化扩展点
-    drawPoint(Ax, osg::Vec4(1,0,0,1));  // 红色
-    drawPoint(ABx, osg::Vec4(0,1,0,1)); // 绿色
-    drawPoint(BCx, osg::Vec4(0,0,1,1)); // 蓝色
-    drawPoint(Cx, osg::Vec4(1,1,0,1));  // 黄色
+    const osg::Vec3 points[3] = { A, B, C };
+    generateCurvedCorners(points, 3, width, normal);
+}
 
-    // 步骤9-11: 计算中垂线
-    osg::Vec3 AABx = ABx - Ax;
-    osg::Vec3 BCxC = Cx - BCx;
-    osg::Vec3 ABCM = mirrorVector(AABx, BCxC);
+// 批量向量视图（可按元素偏移，用于相邻转角共享同一缓冲）
+static Vec3Span spanOf(const CenterlineBuffers& buffer, size_t offset = 0) {
+    Vec3Span span = { buffer.x.data() + offset, buffer.y.data() + offset, buffer.z.data() + offset };
+    return span;
+}
 
-    // 步骤13-14: 创建射线
-    Ray R1 = createRay(Ax, ABx);
-    Ray R2 = createRay(BCx, Cx);
+static Vec3OutSpan outOf(CenterlineBuffers& buffer) {
+    Vec3OutSpan span = { buffer.x.data(), buffer.y.data(), buffer.z.data() };
+    return span;
+}
 
-    // 步骤15-20: 计算关键点
-    osg::Vec3 P1 = findClosestPoint(R1, R2.origin);
-    osg::Vec3 P2 = findClosestPoint(R2, R1.origin);
-    osg::Vec3 M12 = findMiddlePoint(P1, P2);
-    osg::Vec3 P3 = M12 + (ABCM * width);
+// 多段线每个内部顶点按A-B-C转角构造扩展点与切点，全部转角一次性经批量内核计算
+// 第i个转角的A、B、C为points[i]、points[i+1]、points[i+2]，路径向量Vab、Vbc为相邻差分
+void CurvedRoadGenerator::generateCurvedCorners(const osg::Vec3* points, size_t count, float width,
+                                                const osg::Vec3& normal) {
+    if(count < 3) return;
+    const size_t corners = count - 2;
     
-    osg::Vec3 PS = findClosestPoint(R1, P3);
-    osg::Vec3 PE = findClosestPoint(R2, P3);
-
-    // 可视化关键点
-    drawPoint(PS, osg::Vec4(1,0,1,1)); // 紫色
-    drawPoint(PE, osg::Vec4(0,1,1,1)); // 青色
-
-    // 生成路面几何体
+    // 步骤1-2: 顶点与路径向量（结构数组布局）
+    CenterlineBuffers P, D;
+    P.resize(count);
+    D.resize(count - 1);
+    for(size_t i=0; i<count; ++i) {
+        P.x[i] = points[i].x();
+        P.y[i] = points[i].y();
+        P.z[i] = points[i].z();
+    }
+    for(size_t i=0; i+1<count; ++i) {
+        D.x[i] = P.x[i+1] - P.x[i];
+        D.y[i] = P.y[i+1] - P.y[i];
+        D.z[i] = P.z[i+1] - P.z[i];
+    }
+    
+    // 步骤3-8: 计算扩展点
+    CenterlineBuffers Ax, BCx, Cx;
+    Ax.resize(corners);
+    BCx.resize(corners);
+    Cx.resize(corners);
+    batchOffset(spanOf(P, 0), spanOf(D, 0), normal, width, outOf(Ax), corners);
+    batchOffset(spanOf(P, 1), spanOf(D, 1), normal, width, outOf(BCx), corners);
+    batchOffset(spanOf(P, 2), spanOf(D, 1), normal, width, outOf(Cx), corners);
+    
+    // 步骤9-11: 中垂线方向（扩展边与路径向量平行）
+    CenterlineBuffers ABCM;
+    ABCM.resize(corners);
+    batchMirror(spanOf(D, 0), spanOf(D, 1), outOf(ABCM), corners);
+    
+    // 步骤13-20: 射线R1 = (Ax, Vab)、R2 = (BCx, Vbc) 上的关键点
+    CenterlineBuffers P1, P2, PS, PE;
+    P1.resize(corners);
+    P2.resize(corners);
+    PS.resize(corners);
+    PE.resize(corners);
+    batchClosestPoint(spanOf(Ax), spanOf(D, 0), spanOf(BCx), outOf(P1), corners);
+    batchClosestPoint(spanOf(BCx), spanOf(D, 1), spanOf(Ax), outOf(P2), corners);
+    batchMiddlePoint(spanOf(P1), spanOf(P2), outOf(P2), corners);
+    for(size_t i=0; i<corners; ++i) {
+        P2.x[i] += ABCM.x[i] * width;
+        P2.y[i] += ABCM.y[i] * width;
+        P2.z[i] += ABCM.z[i] * width;
+    }
+    batchClosestPoint(spanOf(Ax), spanOf(D, 0), spanOf(P2), outOf(PS), corners);
+    batchClosestPoint(spanOf(BCx), spanOf(D, 1), spanOf(P2), outOf(PE), corners);
+    
+    // 生成路面几何体（每个转角一个四边形，外角在切点PS、PE处截去，共用一个几何体）
     osg::ref_ptr<osg::Geode> roadGeode = new osg::Geode();
     osg::ref_ptr<osg::Geometry> roadGeom = new osg::Geometry();
     osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array();
-    
-    // 添加路面顶点（示例四边形）
-    vertices->push_back(Ax);
-    vertices->push_back(ABx);
-    vertices->push_back(BCx);
-    vertices->push_back(Cx);
+    vertices->reserve(corners * 4);
+    for(size_t i=0; i<corners; ++i) {
+        vertices->push_back(Ax.at(i));
+        vertices->push_back(PS.at(i));
+        vertices->push_back(PE.at(i));
+        vertices->push_back(Cx.at(i));
+    }
     
     roadGeom->setVertexArray(vertices);
-    roadGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::QUADS, 0, 4));
+    roadGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::QUADS, 0, vertices->size()));
     roadGeode->addDrawable(roadGeom);
     root->addChild(roadGeode);
 }
 
-// 计算垂直向量（归一化）
-osg::Vec3 CurvedRoadGenerator::computePerpendicularVector(const osg::Vec3& vec, 
-                                                        const osg::Vec3& normal) {
-    osg::Vec3 cross = vec ^ normal; // OSG的叉乘运算符
-    return cross.normalize();
-}
-
-// 创建射线
-Ray CurvedRoadGenerator::createRay(const osg::Vec3& p1, const osg::Vec3& p2) {
-    return Ray(p1, p2 - p1);
-}
-
-// 计算射线上最近点
-osg::Vec3 CurvedRoadGenerator::findClosestPoint(const Ray& ray, 
-                                              const osg::Vec3& point) {
-    osg::Vec3 diff = point - ray.origin;
-    float t = diff * ray.direction; // 点积计算投影参数
-    return ray.origin + ray.direction * t;
-}
-
-// 计算中点
-osg::Vec3 CurvedRoadGenerator::findMiddlePoint(const osg::Vec3& p1, 
-                                             const osg::Vec3& p2) {
-    return (p1 + p2) * 0.5f;
+// 流式读取Shapefile中线，逐条生成圆角路面
+// 返回处理的线要素数量；若属性表含width字段则按要素覆盖路宽
+int CurvedRoadGenerator::generateFromShapefile(const QString& path, float width,
+                                               const osg::Vec3& normal) {
+    ShapefileReader reader;
+    if(!reader.open(path)) {
+        qWarning() << reader.errorString();
+        return 0;
+    }
+
+    // 以数据集包围盒最小角为局部原点，避免大坐标的单精度误差
+    const osg::Vec3d origin = reader.bounds()._min;
+    return reader.forEachPolyline([&](const PolylineView& shape, const DbfRecordView& attributes) {
+        bool ok = false;
+        float featureWidth = attributes.toDouble(attributes.fieldIndex("width"), &ok);
+        generatePolyline(shape, ok && featureWidth > 0 ? featureWidth : width, normal, origin);
+        return true;
+    });
 }
 
-// 镜像向量计算（中垂线方向）
-osg::Vec3 CurvedRoadGenerator::mirrorVector(const osg::Vec3& v1, 
-                                          const osg::Vec3& v2) {
-    // 计算两个向量的平均方向
-    osg::Vec3 sum = v1 + v2;
-    return sum.normalize();
+// 多段线道路：一次处理全部转角，生成单个三角带几何体
+void CurvedRoadGenerator::generatePolylineRoad(const osg::Vec3* points, size_t count, float width,
+                                               float radius, const osg::Vec3& normal) {
+    PolylineRoadParameters params = {
+        width,          // width
+        radius,         // filletRadius
+        0.01f * width,  // arcTolerance
+        normal          // normal
+    };
+    PolylineRoadEngine engine(params);
+    osg::ref_ptr<osg::Geometry> roadGeom = engine.build(points, count);
+    if(!roadGeom) return;
+    
+    osg::ref_ptr<osg::Geode> roadGeode = new osg::Geode();
+    roadGeode->addDrawable(roadGeom);
+    root->addChild(roadGeode);
 }
 
-// 可视化辅助函数：绘制点
-void CurvedRoadGenerator::drawPoint(const osg::Vec3& pos, 
-                                   const osg::Vec4& color) {
-    osg::ref_ptr<osg::Geode> geode = new osg::Geode();
-    osg::ref_ptr<osg::ShapeDrawable> shape = new osg::ShapeDrawable(
-        new osg::Sphere(pos, 0.1f));
-    shape->setColor(color);
-    geode->addDrawable(shape);
-    root->addChild(geode);
+// 对单条线要素的每个部件生成圆角路面；全部转角经一次批量构造输出转角面
+void CurvedRoadGenerator::generatePolyline(const PolylineView& shape, float width,
+                                           const osg::Vec3& normal, const osg::Vec3d& origin) {
+    for(int part=0; part<shape.numParts(); ++part) {
+        int begin = shape.partBegin(part);
+        int end = shape.partEnd(part);
+        if(end - begin < 2) continue;
+
+        // 仅解码当前部件的坐标
+        partPoints.clear();
+        partPoints.reserve(end - begin);
+        for(int i=begin; i<end; ++i) {
+            partPoints.push_back(osg::Vec3(shape.point(i) - origin));
+        }
+        generateCurvedCorners(partPoints.data(), partPoints.size(), width, normal);
+        generatePolylineRoad(partPoints.data(), partPoints.size(), width, width * 4.0f, normal);
+    }
 }
 
 // 可视化辅助函数：绘制线
@@ -156,12 +177,4 @@ void CurvedRoadGenerator::drawLine(const osg::Vec3& start,
     
     geode->addDrawable(geom);
     root->addChild(geode);
-}
-
-// Qt主函数
-int main(int argc, char** argv) {
-    QApplication app(argc, argv);
-    CurvedRoadGenerator window;
-    window.show();
-    return app.exec();
 }
\ No newline at end of file
@@ -1,37 +1,33 @@
 #pragma once
 #include <osg/Vec3>
+#include <osg/Vec3d>
 #include <osg/Geometry>
-#include <osgViewer/Viewer>
-#include <QMainWindow>
+#include <QString>
 #include <vector>
 
-// 自定义射线结构体
-struct Ray {
-    osg::Vec3 origin;
-    osg::Vec3 direction;
-    Ray(const osg::Vec3& o, const osg::Vec3& d) : origin(o), direction(d) {}
-};
+class PolylineView;
 
-class CurvedRoadGenerator : public QMainWindow {
-    Q_OBJECT
+// 弯道路面生成引擎（不依赖窗口，可在无显示环境下运行）
+class CurvedRoadGenerator {
 public:
-    CurvedRoadGenerator(QWidget* parent = nullptr);
+    CurvedRoadGenerator();
+    osg::Group* getRoot() const { return root.get(); }
     void generateCurvedRoad(const osg::Vec3& A, const osg::Vec3& B, const osg::Vec3& C, 
                           float width, const osg::Vec3& normal);
+    void generateCurvedCorners(const osg::Vec3* points, size_t count, float width, const osg::Vec3& normal);
+    void generatePolylineRoad(const osg::Vec3* points, size_t count, float width,
+                              float radius, const osg::Vec3& normal);
+    void generatePolyline(const PolylineView& shape, float width, const osg::Vec3& normal,
+                          const osg::Vec3d& origin);
+    int generateFromShapefile(const QString& path, float width, const osg::Vec3& normal);
 
 private:
-    // OSG可视化组件
-    osg::ref_ptr<osgViewer::Viewer> viewer;
+    // OSG场景组件
     osg::ref_ptr<osg::Group> root;
     
-    // 算法核心函数
-    osg::Vec3 computePerpendicularVector(const osg::Vec3& vec, const osg::Vec3& normal);
-    Ray createRay(const osg::Vec3& p1, const osg::Vec3& p2);
-    osg::Vec3 findClosestPoint(const Ray& ray, const osg::Vec3& point);
-    osg::Vec3 findMiddlePoint(const osg::Vec3& p1, const osg::Vec3& p2);
-    osg::Vec3 mirrorVector(const osg::Vec3& v1, const osg::Vec3& v2);
+    // 线要素坐标暂存（按部件复用）
+    std::vector<osg::Vec3> partPoints;
     
     // 可视化辅助函数
-    void drawPoint(const osg::Vec3& pos, const osg::Vec4& color);
     void drawLine(const osg::Vec3& start, const osg::Vec3& end, const osg::Vec4& color);
 };
\ No newline at end of file
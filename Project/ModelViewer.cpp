@@ -0,0 +1,62 @@
+#include "ModelViewer.h"
+#include "CurveModel.h"
+#include "BridgeModel.h"
+#include "TunnelModel.h"
+#include "SlopeModel.h"
+#include "TextureCache.h"
+#include <QApplication>
+#include <QHBoxLayout>
+#include <cstring>
+
+// 构造函数
+ModelViewer::ModelViewer(osg::Node* scene, QWidget* parent) : QMainWindow(parent), sceneData(scene) {
+    // Qt窗口设置
+    setGeometry(100, 100, 1200, 800);
+    QWidget* centralWidget = new QWidget(this);
+    QHBoxLayout* layout = new QHBoxLayout(centralWidget);
+    
+    // 设置场景数据
+    viewer = new osgViewer::Viewer();
+    viewer->setSceneData(sceneData);
+    viewer->realize();
+}
+
+// 按模型名称运行对应建模流程
+static osg::ref_ptr<osg::Node> buildScene(const char* model) {
+    if(strcmp(model, "bridge") == 0) {
+        BridgeBuilder builder;
+        builder.run();
+        return builder.getRoot();
+    }
+    if(strcmp(model, "tunnel") == 0) {
+        TunnelBuilder builder;
+        builder.run();
+        return builder.getRoot();
+    }
+    if(strcmp(model, "slope") == 0) {
+        SlopeModeler modeler;
+        modeler.run();
+        return modeler.getRoot();
+    }
+
+    // 弯道路面：优先从示例路网数据生成，失败时使用示例三点
+    CurvedRoadGenerator generator;
+    float width = 2.0f;
+    osg::Vec3 normal(0, 0, 1);
+    if(generator.generateFromShapefile("Test road/test road.shp", width, normal) == 0) {
+        osg::Vec3 A(0, 0, 0);
+        osg::Vec3 B(10, 5, 0);
+        osg::Vec3 C(20, 0, 0);
+        generator.generateCurvedRoad(A, B, C, width, normal);
+    }
+    return generator.getRoot();
+}
+
+// Qt主函数（用法：ModelViewer [curve|bridge|tunnel|slope]）
+int main(int argc, char** argv) {
+    QApplication app(argc, argv);
+    TextureCache::instance().preloadAsync(); // 纹理在后台解码，与地形和几何构建并行
+    ModelViewer window(buildScene(argc > 1 ? argv[1] : "curve"));
+    window.show();
+    return app.exec();
+}
\ No newline at end of file
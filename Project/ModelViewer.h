@@ -0,0 +1,16 @@
+#pragma once
+#include <osg/Node>
+#include <osgViewer/Viewer>
+#include <QMainWindow>
+
+// 模型浏览窗口：只负责显示建模引擎生成的场景
+class ModelViewer : public QMainWindow {
+    Q_OBJECT
+public:
+    ModelViewer(osg::Node* scene, QWidget* parent = nullptr);
+
+private:
+    // OSG可视化组件
+    osg::ref_ptr<osgViewer::Viewer> viewer;
+    osg::ref_ptr<osg::Node> sceneData;
+};
\ No newline at end of file
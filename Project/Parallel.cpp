@@ -0,0 +1,142 @@
+#include "Parallel.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 单个线程的任务区间
+struct WorkRange {
+    std::atomic<size_t> next;
+    size_t end;
+};
+
+// 一次并行调用的共享状态（由参与线程共同持有，晚到的线程领不到任务即退出）
+struct ParallelJob {
+    std::unique_ptr<WorkRange[]> ranges;
+    size_t workers;
+    const std::function<void(size_t)>* body;
+    std::atomic<size_t> remaining;      // 尚未完成的任务数
+    std::mutex mutex;
+    std::condition_variable finished;
+};
+
+// 当前线程处于并行任务中（线程池线程始终为真）
+static thread_local bool parallelRegion = false;
+
+// 常驻线程池：按需增长到请求的线程数，进程退出时回收
+class ThreadPool {
+public:
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for(auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void reserve(size_t count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        while(threads.size() < count) {
+            threads.emplace_back([this]() { run(); });
+        }
+    }
+
+    void submit(std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.push_back(std::move(task));
+        }
+        wake.notify_one();
+    }
+
+private:
+    void run() {
+        parallelRegion = true;
+        for(;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this]() { return stopping || !tasks.empty(); });
+                if(tasks.empty()) return;
+                task = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            task();
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::deque<std::function<void()>> tasks;
+    std::vector<std::thread> threads;
+    bool stopping = false;
+};
+
+static ThreadPool& threadPool() {
+    static ThreadPool pool;
+    return pool;
+}
+
+int resolveThreadCount(int requested) {
+    if(requested > 0) return requested;
+    return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+bool inParallelRegion() {
+    return parallelRegion;
+}
+
+// 参与者：先消费自己的区间，再按顺序窃取其他区间
+static void runWorker(ParallelJob& job, size_t self) {
+    size_t done = 0;
+    for(size_t k=0; k<job.workers; ++k) {
+        WorkRange& range = job.ranges[(self + k) % job.workers];
+        for(size_t i = range.next++; i < range.end; i = range.next++) {
+            (*job.body)(i);
+            ++done;
+        }
+    }
+    if(done > 0 && job.remaining.fetch_sub(done) == done) {
+        std::lock_guard<std::mutex> lock(job.mutex);
+        job.finished.notify_all();
+    }
+}
+
+void parallelFor(size_t count, int threadCount, const std::function<void(size_t)>& body) {
+    size_t workers = std::min(count, static_cast<size_t>(resolveThreadCount(threadCount)));
+    if(workers <= 1 || parallelRegion) {
+        for(size_t i=0; i<count; ++i) body(i);
+        return;
+    }
+
+    // 初始均分任务区间
+    std::shared_ptr<ParallelJob> job = std::make_shared<ParallelJob>();
+    job->ranges.reset(new WorkRange[workers]);
+    job->workers = workers;
+    job->body = &body;
+    job->remaining = count;
+    for(size_t w=0; w<workers; ++w) {
+        job->ranges[w].next = count * w / workers;
+        job->ranges[w].end = count * (w + 1) / workers;
+    }
+
+    ThreadPool& pool = threadPool();
+    pool.reserve(workers - 1);
+    for(size_t w=1; w<workers; ++w) {
+        pool.submit([job, w]() { runWorker(*job, w); });
+    }
+
+    // 调用线程作为第0个参与者，随后等待其余任务完成
+    parallelRegion = true;
+    runWorker(*job, 0);
+    parallelRegion = false;
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&]() { return job->remaining.load() == 0; });
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+// 解析线程数设置（<=0 表示使用全部硬件线程）
+int resolveThreadCount(int requested);
+
+// 并行执行 body(0..count-1)
+// 任务在进程级常驻线程池上执行，调用线程同时参与计算；
+// 每个线程先处理自己的连续区间，完成后从其他线程区间窃取剩余任务
+// 在并行任务内部再次调用时按串行执行，避免线程数按层级相乘
+void parallelFor(size_t count, int threadCount, const std::function<void(size_t)>& body);
+
+// 当前线程是否正在执行并行任务
+bool inParallelRegion();
\ No newline at end of file
@@ -0,0 +1,76 @@
+// 并行循环扩展性基准：1到64线程
+// 用法：ParallelBench [--vertices N] [--repeat R] [--max-threads T]
+#include "Parallel.h"
+#include "PolylineRoad.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+// 多次运行取最短耗时（毫秒）
+static double bestTime(int repeat, const std::function<void()>& body) {
+    double best = 1e30;
+    for(int r=0; r<repeat; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+int main(int argc, char** argv) {
+    size_t vertices = 1 << 20;
+    int repeat = 3;
+    int maxThreads = 64;
+    for(int i=1; i+1<argc; i += 2) {
+        if(strcmp(argv[i], "--vertices") == 0) vertices = static_cast<size_t>(atoll(argv[i+1]));
+        else if(strcmp(argv[i], "--repeat") == 0) repeat = std::max(1, atoi(argv[i+1]));
+        else if(strcmp(argv[i], "--max-threads") == 0) maxThreads = std::max(1, atoi(argv[i+1]));
+    }
+
+    // 锯齿形中线，每个顶点都是转角
+    std::vector<osg::Vec3> points(vertices);
+    for(size_t i=0; i<vertices; ++i) {
+        points[i] = osg::Vec3(i * 10.0f, (i % 2) * 6.0f, 0.0f);
+    }
+    PolylineRoadParameters params = {
+        3.5f,                   // width
+        20.0f,                  // filletRadius
+        0.01f,                  // arcTolerance
+        osg::Vec3(0, 0, 1)      // normal
+    };
+
+    // 计算密集型循环：每个任务独立累加一段三角函数
+    const size_t blocks = 4096;
+    const size_t blockSize = 16384;
+    std::vector<double> partial(blocks);
+    auto compute = [&](size_t b) {
+        double sum = 0;
+        for(size_t k=0; k<blockSize; ++k) sum += sin(static_cast<double>(b * blockSize + k) * 1e-3);
+        partial[b] = sum;
+    };
+
+    printf("硬件线程: %d，中线顶点: %zu\n", resolveThreadCount(0), vertices);
+    printf("%8s %14s %8s %14s %8s %10s\n", "线程", "计算(ms)", "加速", "圆角路面(ms)", "加速", "采样点");
+    double computeBase = 0, roadBase = 0;
+    for(int threads=1; threads<=maxThreads; threads *= 2) {
+        double computeMs = bestTime(repeat, [&]() { parallelFor(blocks, threads, compute); });
+
+        PolylineRoadEngine engine(params);
+        engine.setThreadCount(threads);
+        engine.setChunkSize(1024);
+        double roadMs = bestTime(repeat, [&]() { osg::ref_ptr<osg::Geometry> geom = engine.build(points.data(), points.size()); });
+
+        if(threads == 1) {
+            computeBase = computeMs;
+            roadBase = roadMs;
+        }
+        printf("%8d %14.2f %8.2f %14.2f %8.2f %10zu\n", threads, computeMs, computeBase / computeMs,
+               roadMs, roadBase / roadMs, engine.centerline().size());
+    }
+    return 0;
+}
\ No newline at end of file
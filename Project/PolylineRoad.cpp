@@ -0,0 +1,166 @@
+#include "PolylineRoad.h"
+#include "RoadKernels.h"
+#include "Parallel.h"
+#include <algorithm>
+#include <cmath>
+
+// 退化转角判定阈值（弧度）
+static const float kMinTurnAngle = 1e-4f;
+static const int kMaxArcSegments = 64;
+static const size_t kDefaultChunkCorners = 4096;
+
+PolylineRoadEngine::PolylineRoadEngine(const PolylineRoadParameters& parameters)
+    : params(parameters), threadCount(0), chunkCorners(kDefaultChunkCorners) {
+}
+
+// 生成整条中线的圆角路面
+osg::Geometry* PolylineRoadEngine::build(const osg::Vec3* points, size_t count) {
+    samples.clear();
+    if(count < 2) return nullptr;
+
+    // 转角按块划分，短中线只有一个块时直接串行
+    const size_t corners = count - 2;
+    const size_t chunks = std::max<size_t>(1, (corners + chunkCorners - 1) / chunkCorners);
+    std::vector<CenterlineBuffers> chunkSamples(chunks);
+    parallelFor(chunks, chunks > 1 ? threadCount : 1, [&](size_t c) {
+        size_t first = 1 + c * chunkCorners;
+        size_t last = std::min(count - 1, first + chunkCorners);
+        filletRange(points, count, first, last, chunkSamples[c]);
+    });
+
+    // 按块序计算输出偏移，保证拼接结果与线程数无关
+    std::vector<size_t> offsets(chunks + 1);
+    offsets[0] = 1;
+    for(size_t c=0; c<chunks; ++c) {
+        offsets[c + 1] = offsets[c] + chunkSamples[c].size();
+    }
+    samples.resize(offsets[chunks] + 1);
+    samples.x[0] = points[0].x();
+    samples.y[0] = points[0].y();
+    samples.z[0] = points[0].z();
+    parallelFor(chunks, chunks > 1 ? threadCount : 1, [&](size_t c) {
+        const CenterlineBuffers& src = chunkSamples[c];
+        std::copy(src.x.begin(), src.x.end(), samples.x.begin() + offsets[c]);
+        std::copy(src.y.begin(), src.y.end(), samples.y.begin() + offsets[c]);
+        std::copy(src.z.begin(), src.z.end(), samples.z.begin() + offsets[c]);
+    });
+    samples.x.back() = points[count - 1].x();
+    samples.y.back() = points[count - 1].y();
+    samples.z.back() = points[count - 1].z();
+
+    return emitStrip();
+}
+
+// 按弦高容差计算圆弧分段数
+int PolylineRoadEngine::arcSegments(float radius, float angle) const {
+    if(radius <= params.arcTolerance) return 1;
+    float step = 2.0f * acosf(1.0f - params.arcTolerance / radius);
+    return std::min(kMaxArcSegments, std::max(1, static_cast<int>(ceilf(angle / step))));
+}
+
+// 处理转角区间[first, last)，每个转角只依赖相邻两个顶点
+void PolylineRoadEngine::filletRange(const osg::Vec3* points, size_t count, size_t first, size_t last,
+                                     CenterlineBuffers& out) const {
+    // 预估采样点数，避免逐点扩容
+    out.reserve((last - first) * 4);
+    for(size_t i=first; i<last; ++i) {
+        // 每段长度由前后两个转角平分；首尾段同样只用一半，切点不会落在中线端点上
+        float prevAvailable = (points[i] - points[i-1]).length() * 0.5f;
+        float nextAvailable = (points[i+1] - points[i]).length() * 0.5f;
+        filletCorner(points[i-1], points[i], points[i+1], prevAvailable, nextAvailable, out);
+    }
+}
+
+// 单个转角圆角：切点PS、PE之间插入圆弧采样点
+void PolylineRoadEngine::filletCorner(const osg::Vec3& A, const osg::Vec3& B, const osg::Vec3& C,
+                                      float prevAvailable, float nextAvailable,
+                                      CenterlineBuffers& out) const {
+    osg::Vec3 d0 = B - A;
+    osg::Vec3 d1 = C - B;
+    if(d0.normalize() <= 0 || d1.normalize() <= 0) return;
+
+    float angle = acosf(osg::clampBetween(d0 * d1, -1.0f, 1.0f));
+    if(angle < kMinTurnAngle || angle > osg::PI - kMinTurnAngle) {
+        out.push(B);
+        return;
+    }
+
+    // 切线长受相邻线段可用长度限制，必要时缩小半径
+    float halfTan = tanf(angle * 0.5f);
+    float tangentLength = std::min(params.filletRadius * halfTan, std::min(prevAvailable, nextAvailable));
+    float radius = tangentLength / halfTan;
+
+    osg::Vec3 PS = B - d0 * tangentLength;
+    osg::Vec3 PE = B + d1 * tangentLength;
+    osg::Vec3 bisector = d1 - d0;
+    bisector.normalize();
+    osg::Vec3 center = B + bisector * (radius / cosf(angle * 0.5f));
+
+    // 球面线性插值生成圆弧
+    osg::Vec3 v0 = PS - center;
+    osg::Vec3 v1 = PE - center;
+    int segments = arcSegments(radius, angle);
+    float invSin = 1.0f / sinf(angle);
+    for(int k=0; k<=segments; ++k) {
+        float t = k / static_cast<float>(segments);
+        out.push(center + (v0 * sinf((1.0f - t) * angle) + v1 * sinf(t * angle)) * invSin);
+    }
+}
+
+// 生成采样区间[first, last)对应的左右边线顶点
+void PolylineRoadEngine::emitRange(size_t first, size_t last, osg::Vec3Array& vertices,
+                                   osg::DrawElementsUInt& indices) const {
+    const size_t n = samples.size();
+    const size_t m = last - first;
+    const float halfWidth = params.width * 0.5f;
+
+    // 中心差分求切向（跨块读取全局采样，块边界无需特殊处理）
+    std::vector<float> tx(m), ty(m), tz(m);
+    for(size_t k=0; k<m; ++k) {
+        size_t i = first + k;
+        size_t prev = i > 0 ? i - 1 : 0;
+        size_t next = i + 1 < n ? i + 1 : n - 1;
+        tx[k] = samples.x[next] - samples.x[prev];
+        ty[k] = samples.y[next] - samples.y[prev];
+        tz[k] = samples.z[next] - samples.z[prev];
+    }
+
+    // 批量计算单位侧向（原地覆盖切向缓冲）
+    Vec3Span tangents = { tx.data(), ty.data(), tz.data() };
+    Vec3OutSpan sides = { tx.data(), ty.data(), tz.data() };
+    batchPerpendicular(tangents, params.normal, sides, m);
+
+    for(size_t k=0; k<m; ++k) {
+        size_t i = first + k;
+        osg::Vec3 side = osg::Vec3(tx[k], ty[k], tz[k]) * halfWidth;
+        osg::Vec3 c = samples.at(i);
+        vertices[2*i] = c + side;
+        vertices[2*i + 1] = c - side;
+        indices[2*i] = static_cast<GLuint>(2*i);
+        indices[2*i + 1] = static_cast<GLuint>(2*i + 1);
+    }
+}
+
+// 由中线采样生成左右边线并输出单个索引三角带
+osg::Geometry* PolylineRoadEngine::emitStrip() const {
+    const size_t n = samples.size();
+    osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array(static_cast<unsigned int>(n * 2));
+    osg::ref_ptr<osg::DrawElementsUInt> indices =
+        new osg::DrawElementsUInt(osg::PrimitiveSet::TRIANGLE_STRIP, static_cast<unsigned int>(n * 2));
+
+    // 各块写入互不重叠的顶点区间
+    const size_t chunkSamples = chunkCorners * 4;
+    const size_t chunks = (n + chunkSamples - 1) / chunkSamples;
+    parallelFor(chunks, chunks > 1 ? threadCount : 1, [&](size_t c) {
+        emitRange(c * chunkSamples, std::min(n, (c + 1) * chunkSamples), *vertices, *indices);
+    });
+
+    osg::ref_ptr<osg::Vec3Array> normals = new osg::Vec3Array();
+    normals->push_back(params.normal);
+
+    osg::Geometry* geom = new osg::Geometry();
+    geom->setVertexArray(vertices);
+    geom->setNormalArray(normals, osg::Array::BIND_OVERALL);
+    geom->addPrimitiveSet(indices);
+    return geom;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <osg/Vec3>
+#include <osg/Geometry>
+#include <vector>
+
+// 多段线道路参数
+struct PolylineRoadParameters {
+    float width;            // 路面宽度
+    float filletRadius;     // 转角圆弧半径
+    float arcTolerance;     // 圆弧弦高容差
+    osg::Vec3 normal;       // 路面法向
+};
+
+// 中线采样缓冲（结构数组布局，按分量连续存放）
+struct CenterlineBuffers {
+    std::vector<float> x, y, z;
+
+    size_t size() const { return x.size(); }
+    void clear() { x.clear(); y.clear(); z.clear(); }
+    void reserve(size_t n) { x.reserve(n); y.reserve(n); z.reserve(n); }
+    void resize(size_t n) { x.resize(n); y.resize(n); z.resize(n); }
+    void push(const osg::Vec3& p) { x.push_back(p.x()); y.push_back(p.y()); z.push_back(p.z()); }
+    osg::Vec3 at(size_t i) const { return osg::Vec3(x[i], y[i], z[i]); }
+};
+
+// 多段线圆角道路引擎：一次遍历完成全部转角圆角，输出单个索引三角带几何体
+// 长中线按转角分块并行生成，分块结果按块序拼接，输出与串行结果一致
+class PolylineRoadEngine {
+public:
+    explicit PolylineRoadEngine(const PolylineRoadParameters& parameters);
+
+    void setThreadCount(int threads) { threadCount = threads; }
+    void setChunkSize(size_t corners) { chunkCorners = corners > 0 ? corners : 1; }
+
+    osg::Geometry* build(const osg::Vec3* points, size_t count);
+    const CenterlineBuffers& centerline() const { return samples; }
+
+private:
+    int arcSegments(float radius, float angle) const;
+    void filletRange(const osg::Vec3* points, size_t count, size_t first, size_t last,
+                     CenterlineBuffers& out) const;
+    void filletCorner(const osg::Vec3& A, const osg::Vec3& B, const osg::Vec3& C,
+                      float prevAvailable, float nextAvailable, CenterlineBuffers& out) const;
+    void emitRange(size_t first, size_t last, osg::Vec3Array& vertices,
+                   osg::DrawElementsUInt& indices) const;
+    osg::Geometry* emitStrip() const;
+
+    PolylineRoadParameters params;
+    CenterlineBuffers samples;
+    int threadCount;        // <=0 表示使用全部硬件线程，1 为串行
+    size_t chunkCorners;    // 每个并行块包含的转角数
+};
\ No newline at end of file
@@ -0,0 +1,223 @@
+#include "RegionLabeling.h"
+#include "Parallel.h"
+#include "UnionFind.h"
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+
+// 单个瓦片的标记结果
+struct TileLabels {
+    int x0, y0, width, height;
+    std::vector<TerrainRegion> regions;     // 局部区域统计
+    std::vector<int> left, right;           // 左右边界列标签（-1 表示非目标格点）
+    std::vector<int> top, bottom;           // 上下边界行标签
+    int offset;                             // 全局编号偏移
+};
+
+// 合并区域统计
+static void mergeRegion(TerrainRegion& into, const TerrainRegion& from) {
+    into.cellCount += from.cellCount;
+    into.xMin = std::min(into.xMin, from.xMin);
+    into.yMin = std::min(into.yMin, from.yMin);
+    into.xMax = std::max(into.xMax, from.xMax);
+    into.yMax = std::max(into.yMax, from.yMax);
+    if(from.chainageMin < into.chainageMin) {
+        into.chainageMin = from.chainageMin;
+        into.first = from.first;
+    }
+    if(from.chainageMax > into.chainageMax) {
+        into.chainageMax = from.chainageMax;
+        into.last = from.last;
+    }
+}
+
+// 瓦片内两遍扫描标记
+static void labelTile(const Terrain* terrain, const CellPredicate& predicate,
+                      const HorizontalAlignment& alignment, float maxOffset, TileLabels& tile) {
+    const int w = tile.width;
+    const int h = tile.height;
+
+    // 整个瓦片都在走廊外时不读高程，边界标签全部为-1
+    const osg::Vec3& terrainOrigin = terrain->getOrigin();
+    const float spacing = terrain->getSpacing();
+    const osg::Vec3 centre(terrainOrigin.x() + (tile.x0 + 0.5f * (w - 1)) * spacing,
+                           terrainOrigin.y() + (tile.y0 + 0.5f * (h - 1)) * spacing, 0.0f);
+    const float halfDiagonal = 0.5f * spacing * sqrtf(float((w - 1) * (w - 1) + (h - 1) * (h - 1)));
+    float centreOffset;
+    osg::Vec3 nearest = alignment.position(alignment.project(centre, centreOffset));
+    nearest.z() = 0.0f;
+    if((nearest - centre).length() > maxOffset + halfDiagonal) {
+        tile.left.assign(h, -1);
+        tile.right.assign(h, -1);
+        tile.top.assign(w, -1);
+        tile.bottom.assign(w, -1);
+        return;
+    }
+    std::vector<int> labels(w * h, -1);
+    UnionFind sets(0);
+
+    // 瓦片高程与投影桩号逐行批量求取一次（每行只加一次锁），两遍扫描共用
+    std::vector<float> heights(w * h), chainages(w * h), offsets(w * h);
+    std::vector<int> xs(w), ys(w);
+    std::vector<float> worldX(w), worldY(w);
+    for(int i=0; i<w; ++i) {
+        xs[i] = tile.x0 + i;
+        worldX[i] = terrainOrigin.x() + xs[i] * spacing;
+    }
+    for(int j=0; j<h; ++j) {
+        std::fill(ys.begin(), ys.end(), tile.y0 + j);
+        std::fill(worldY.begin(), worldY.end(), terrainOrigin.y() + (tile.y0 + j) * spacing);
+        terrain->gatherHeights(xs.data(), ys.data(), &heights[j*w], w);
+        alignment.project(worldX.data(), worldY.data(), &chainages[j*w], &offsets[j*w], w);
+    }
+    auto vertexAt = [&](int i, int j) {
+        return osg::Vec3(worldX[i], terrainOrigin.y() + (tile.y0 + j) * spacing, heights[j*w + i]);
+    };
+
+    // 偏距是相对所在线段的垂距，在折点外侧与线路两端会小于真实距离，
+    // 垂距通过后再按到最近中线点的平面距离判定
+    auto inCorridor = [&](int i, int j, const osg::Vec3& vertex) {
+        if(fabsf(offsets[j*w + i]) > maxOffset) return false;
+        osg::Vec3 nearest = alignment.position(chainages[j*w + i]) - vertex;
+        nearest.z() = 0.0f;
+        return nearest.length2() <= maxOffset * maxOffset;
+    };
+
+    for(int j=0; j<h; ++j) {
+        for(int i=0; i<w; ++i) {
+            osg::Vec3 vertex = vertexAt(i, j);
+            if(!inCorridor(i, j, vertex) || !predicate(tile.x0 + i, tile.y0 + j, vertex, chainages[j*w + i])) continue;
+
+            int leftLabel = i > 0 ? labels[j*w + i - 1] : -1;
+            int upLabel = j > 0 ? labels[(j-1)*w + i] : -1;
+            int label;
+            if(leftLabel < 0 && upLabel < 0) {
+                label = sets.add();
+            } else if(leftLabel < 0 || upLabel < 0) {
+                label = std::max(leftLabel, upLabel);
+            } else {
+                label = leftLabel;
+                sets.unite(leftLabel, upLabel);
+            }
+            labels[j*w + i] = label;
+        }
+    }
+
+    // 第二遍：压缩为连续编号并累计统计
+    std::vector<int> compact;
+    for(int j=0; j<h; ++j) {
+        for(int i=0; i<w; ++i) {
+            int& label = labels[j*w + i];
+            if(label < 0) continue;
+            int root = sets.find(label);
+            if(static_cast<int>(compact.size()) <= root) compact.resize(root + 1, -1);
+            if(compact[root] < 0) {
+                compact[root] = static_cast<int>(tile.regions.size());
+                TerrainRegion region;
+                region.cellCount = 0;
+                region.xMin = region.yMin = INT_MAX;
+                region.xMax = region.yMax = INT_MIN;
+                region.chainageMin = FLT_MAX;
+                region.chainageMax = -FLT_MAX;
+                tile.regions.push_back(region);
+            }
+            label = compact[root];
+
+            osg::Vec3 vertex = vertexAt(i, j);
+            float chainage = chainages[j*w + i];
+            TerrainRegion cell;
+            cell.cellCount = 1;
+            cell.xMin = cell.xMax = tile.x0 + i;
+            cell.yMin = cell.yMax = tile.y0 + j;
+            cell.chainageMin = cell.chainageMax = chainage;
+            cell.first = cell.last = vertex;
+            mergeRegion(tile.regions[label], cell);
+        }
+    }
+
+    // 保存四条边界的标签，供瓦片间合并
+    tile.left.resize(h);
+    tile.right.resize(h);
+    for(int j=0; j<h; ++j) {
+        tile.left[j] = labels[j*w];
+        tile.right[j] = labels[j*w + w - 1];
+    }
+    tile.top.assign(labels.begin(), labels.begin() + w);
+    tile.bottom.assign(labels.end() - w, labels.end());
+}
+
+std::vector<TerrainRegion> labelTerrainRegions(const Terrain* terrain, const CellPredicate& predicate,
+                                               const HorizontalAlignment& alignment, float maxOffset,
+                                               int threadCount) {
+    if(!alignment.isValid()) return std::vector<TerrainRegion>();
+
+    // 按地形瓦片划分
+    const int tileSize = terrain->getTileSize();
+    const int tilesX = (terrain->getNumColumns() + tileSize - 1) / tileSize;
+    const int tilesY = (terrain->getNumRows() + tileSize - 1) / tileSize;
+    std::vector<TileLabels> tiles(tilesX * tilesY);
+    for(int ty=0; ty<tilesY; ++ty) {
+        for(int tx=0; tx<tilesX; ++tx) {
+            TileLabels& tile = tiles[ty * tilesX + tx];
+            tile.x0 = tx * tileSize;
+            tile.y0 = ty * tileSize;
+            tile.width = std::min(tileSize, terrain->getNumColumns() - tile.x0);
+            tile.height = std::min(tileSize, terrain->getNumRows() - tile.y0);
+        }
+    }
+
+    // 阶段1：瓦片并行标记
+    parallelFor(tiles.size(), threadCount, [&](size_t t) {
+        labelTile(terrain, predicate, alignment, maxOffset, tiles[t]);
+    });
+
+    // 阶段2：全局编号并沿瓦片边界合并
+    int total = 0;
+    for(auto& tile : tiles) {
+        tile.offset = total;
+        total += static_cast<int>(tile.regions.size());
+    }
+    UnionFind sets(total);
+    for(int ty=0; ty<tilesY; ++ty) {
+        for(int tx=0; tx<tilesX; ++tx) {
+            const TileLabels& tile = tiles[ty * tilesX + tx];
+            if(tx + 1 < tilesX) {
+                const TileLabels& east = tiles[ty * tilesX + tx + 1];
+                for(int j=0; j<tile.height; ++j) {
+                    if(tile.right[j] >= 0 && east.left[j] >= 0) {
+                        sets.unite(tile.offset + tile.right[j], east.offset + east.left[j]);
+                    }
+                }
+            }
+            if(ty + 1 < tilesY) {
+                const TileLabels& south = tiles[(ty + 1) * tilesX + tx];
+                for(int i=0; i<tile.width; ++i) {
+                    if(tile.bottom[i] >= 0 && south.top[i] >= 0) {
+                        sets.unite(tile.offset + tile.bottom[i], south.offset + south.top[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    // 阶段3：按根节点汇总区域
+    std::vector<int> rootIndex(total, -1);
+    std::vector<TerrainRegion> regions;
+    for(const auto& tile : tiles) {
+        for(size_t r=0; r<tile.regions.size(); ++r) {
+            int root = sets.find(tile.offset + static_cast<int>(r));
+            if(rootIndex[root] < 0) {
+                rootIndex[root] = static_cast<int>(regions.size());
+                regions.push_back(tile.regions[r]);
+            } else {
+                mergeRegion(regions[rootIndex[root]], tile.regions[r]);
+            }
+        }
+    }
+
+    std::sort(regions.begin(), regions.end(), [](const TerrainRegion& a, const TerrainRegion& b) {
+        return a.chainageMin < b.chainageMin;
+    });
+    return regions;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include "Alignment.h"
+#include "Terrain.h"
+#include <osg/Vec3>
+#include <functional>
+#include <vector>
+
+// 地形连通区域（4邻接）
+struct TerrainRegion {
+    int cellCount;              // 格点数
+    int xMin, yMin, xMax, yMax; // 格网包围盒
+    float chainageMin;          // 投影到线路的最小桩号
+    float chainageMax;          // 投影到线路的最大桩号
+    osg::Vec3 first;            // 投影最小的格点（世界坐标）
+    osg::Vec3 last;             // 投影最大的格点（世界坐标）
+
+    float extent() const { return chainageMax - chainageMin; }
+};
+
+// 格点判定函数，参数为格网索引、该格点世界坐标及其投影桩号
+typedef std::function<bool(int x, int y, const osg::Vec3& vertex, float chainage)> CellPredicate;
+
+// 并行连通区域标记：各瓦片独立做并查集标记，再沿瓦片边界合并
+// 只保存区域统计与瓦片边界标签，不需要整幅标签图
+// 格点逐行批量投影到平面线形，只有到中线平面距离不超过maxOffset的格点参与标记，
+// 走廊外的地形既不成为候选区域，也不会把走廊内互不相连的区域连成一片
+// 结果按投影起点桩号排序
+std::vector<TerrainRegion> labelTerrainRegions(const Terrain* terrain, const CellPredicate& predicate,
+                                               const HorizontalAlignment& alignment, float maxOffset,
+                                               int threadCount = 0);
\ No newline at end of file
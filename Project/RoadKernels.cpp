@@ -0,0 +1,150 @@
+#include "RoadKernels.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ROAD_KERNEL_SIMD 1
+typedef __m128 simd_t;
+static const size_t kLanes = 4;
+static inline simd_t vload(const float* p) { return _mm_loadu_ps(p); }
+static inline void vstore(float* p, simd_t v) { _mm_storeu_ps(p, v); }
+static inline simd_t vset(float s) { return _mm_set1_ps(s); }
+static inline simd_t vadd(simd_t a, simd_t b) { return _mm_add_ps(a, b); }
+static inline simd_t vsub(simd_t a, simd_t b) { return _mm_sub_ps(a, b); }
+static inline simd_t vmul(simd_t a, simd_t b) { return _mm_mul_ps(a, b); }
+static inline simd_t vsqrt(simd_t a) { return _mm_sqrt_ps(a); }
+// 分母为零的通道结果置零
+static inline simd_t vsafeInv(simd_t a) {
+    simd_t mask = _mm_cmpgt_ps(a, _mm_setzero_ps());
+    return _mm_and_ps(mask, _mm_div_ps(_mm_set1_ps(1.0f), a));
+}
+#endif
+
+// 标量倒数（零长度返回0）
+static inline float safeInv(float a) {
+    return a > 0.0f ? 1.0f / a : 0.0f;
+}
+
+void batchPerpendicular(const Vec3Span& v, const osg::Vec3& normal, const Vec3OutSpan& out, size_t count) {
+    size_t i = 0;
+#ifdef ROAD_KERNEL_SIMD
+    const simd_t nx = vset(normal.x()), ny = vset(normal.y()), nz = vset(normal.z());
+    for(; i + kLanes <= count; i += kLanes) {
+        simd_t x = vload(v.x + i), y = vload(v.y + i), z = vload(v.z + i);
+        simd_t cx = vsub(vmul(y, nz), vmul(z, ny));
+        simd_t cy = vsub(vmul(z, nx), vmul(x, nz));
+        simd_t cz = vsub(vmul(x, ny), vmul(y, nx));
+        simd_t inv = vsafeInv(vsqrt(vadd(vadd(vmul(cx, cx), vmul(cy, cy)), vmul(cz, cz))));
+        vstore(out.x + i, vmul(cx, inv));
+        vstore(out.y + i, vmul(cy, inv));
+        vstore(out.z + i, vmul(cz, inv));
+    }
+#endif
+    for(; i<count; ++i) {
+        osg::Vec3 c = osg::Vec3(v.x[i], v.y[i], v.z[i]) ^ normal;
+        float inv = safeInv(c.length());
+        out.x[i] = c.x() * inv;
+        out.y[i] = c.y() * inv;
+        out.z[i] = c.z() * inv;
+    }
+}
+
+void batchOffset(const Vec3Span& p, const Vec3Span& dir, const osg::Vec3& normal, float width,
+                 const Vec3OutSpan& out, size_t count) {
+    size_t i = 0;
+#ifdef ROAD_KERNEL_SIMD
+    const simd_t nx = vset(normal.x()), ny = vset(normal.y()), nz = vset(normal.z());
+    const simd_t w = vset(width);
+    for(; i + kLanes <= count; i += kLanes) {
+        simd_t x = vload(dir.x + i), y = vload(dir.y + i), z = vload(dir.z + i);
+        simd_t cx = vsub(vmul(y, nz), vmul(z, ny));
+        simd_t cy = vsub(vmul(z, nx), vmul(x, nz));
+        simd_t cz = vsub(vmul(x, ny), vmul(y, nx));
+        simd_t scale = vmul(w, vsafeInv(vsqrt(vadd(vadd(vmul(cx, cx), vmul(cy, cy)), vmul(cz, cz)))));
+        vstore(out.x + i, vadd(vload(p.x + i), vmul(cx, scale)));
+        vstore(out.y + i, vadd(vload(p.y + i), vmul(cy, scale)));
+        vstore(out.z + i, vadd(vload(p.z + i), vmul(cz, scale)));
+    }
+#endif
+    for(; i<count; ++i) {
+        osg::Vec3 c = osg::Vec3(dir.x[i], dir.y[i], dir.z[i]) ^ normal;
+        float scale = width * safeInv(c.length());
+        out.x[i] = p.x[i] + c.x() * scale;
+        out.y[i] = p.y[i] + c.y() * scale;
+        out.z[i] = p.z[i] + c.z() * scale;
+    }
+}
+
+void batchClosestPoint(const Vec3Span& origin, const Vec3Span& dir, const Vec3Span& point,
+                       const Vec3OutSpan& out, size_t count) {
+    size_t i = 0;
+#ifdef ROAD_KERNEL_SIMD
+    for(; i + kLanes <= count; i += kLanes) {
+        simd_t ox = vload(origin.x + i), oy = vload(origin.y + i), oz = vload(origin.z + i);
+        simd_t dx = vload(dir.x + i), dy = vload(dir.y + i), dz = vload(dir.z + i);
+        simd_t ex = vsub(vload(point.x + i), ox);
+        simd_t ey = vsub(vload(point.y + i), oy);
+        simd_t ez = vsub(vload(point.z + i), oz);
+        simd_t dot = vadd(vadd(vmul(ex, dx), vmul(ey, dy)), vmul(ez, dz));
+        simd_t t = vmul(dot, vsafeInv(vadd(vadd(vmul(dx, dx), vmul(dy, dy)), vmul(dz, dz))));
+        vstore(out.x + i, vadd(ox, vmul(dx, t)));
+        vstore(out.y + i, vadd(oy, vmul(dy, t)));
+        vstore(out.z + i, vadd(oz, vmul(dz, t)));
+    }
+#endif
+    for(; i<count; ++i) {
+        osg::Vec3 o(origin.x[i], origin.y[i], origin.z[i]);
+        osg::Vec3 d(dir.x[i], dir.y[i], dir.z[i]);
+        float t = ((osg::Vec3(point.x[i], point.y[i], point.z[i]) - o) * d) * safeInv(d.length2());
+        out.x[i] = o.x() + d.x() * t;
+        out.y[i] = o.y() + d.y() * t;
+        out.z[i] = o.z() + d.z() * t;
+    }
+}
+
+void batchMiddlePoint(const Vec3Span& p1, const Vec3Span& p2, const Vec3OutSpan& out, size_t count) {
+    size_t i = 0;
+#ifdef ROAD_KERNEL_SIMD
+    const simd_t half = vset(0.5f);
+    for(; i + kLanes <= count; i += kLanes) {
+        vstore(out.x + i, vmul(vadd(vload(p1.x + i), vload(p2.x + i)), half));
+        vstore(out.y + i, vmul(vadd(vload(p1.y + i), vload(p2.y + i)), half));
+        vstore(out.z + i, vmul(vadd(vload(p1.z + i), vload(p2.z + i)), half));
+    }
+#endif
+    for(; i<count; ++i) {
+        out.x[i] = (p1.x[i] + p2.x[i]) * 0.5f;
+        out.y[i] = (p1.y[i] + p2.y[i]) * 0.5f;
+        out.z[i] = (p1.z[i] + p2.z[i]) * 0.5f;
+    }
+}
+
+void batchMirror(const Vec3Span& v1, const Vec3Span& v2, const Vec3OutSpan& out, size_t count) {
+    size_t i = 0;
+#ifdef ROAD_KERNEL_SIMD
+    for(; i + kLanes <= count; i += kLanes) {
+        simd_t x = vadd(vload(v1.x + i), vload(v2.x + i));
+        simd_t y = vadd(vload(v1.y + i), vload(v2.y + i));
+        simd_t z = vadd(vload(v1.z + i), vload(v2.z + i));
+        simd_t inv = vsafeInv(vsqrt(vadd(vadd(vmul(x, x), vmul(y, y)), vmul(z, z))));
+        vstore(out.x + i, vmul(x, inv));
+        vstore(out.y + i, vmul(y, inv));
+        vstore(out.z + i, vmul(z, inv));
+    }
+#endif
+    for(; i<count; ++i) {
+        osg::Vec3 sum(v1.x[i] + v2.x[i], v1.y[i] + v2.y[i], v1.z[i] + v2.z[i]);
+        float inv = safeInv(sum.length());
+        out.x[i] = sum.x() * inv;
+        out.y[i] = sum.y() * inv;
+        out.z[i] = sum.z() * inv;
+    }
+}
+
+const char* roadKernelPath() {
+#if defined(ROAD_KERNEL_SIMD)
+    return "SSE";
+#else
+    return "scalar";
+#endif
+}
\ No newline at end of file
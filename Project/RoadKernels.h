@@ -0,0 +1,40 @@
+#pragma once
+#include <osg/Vec3>
+#include <cstddef>
+
+// 批量向量输入（结构数组布局）
+struct Vec3Span {
+    const float* x;
+    const float* y;
+    const float* z;
+};
+
+// 批量向量输出
+struct Vec3OutSpan {
+    float* x;
+    float* y;
+    float* z;
+};
+
+// 弯道几何批量计算内核，x86-64基线SSE2实现，剩余元素走标量路径
+// 与CurvedRoadGenerator中的单点函数一一对应，零长度向量归一化结果为零向量
+
+// 垂直向量：normalize(v ^ normal)
+void batchPerpendicular(const Vec3Span& v, const osg::Vec3& normal, const Vec3OutSpan& out, size_t count);
+
+// 偏移点：p + normalize(dir ^ normal) * width
+void batchOffset(const Vec3Span& p, const Vec3Span& dir, const osg::Vec3& normal, float width,
+                 const Vec3OutSpan& out, size_t count);
+
+// 射线最近点：origin + dir * ((point - origin)·dir / |dir|²)，方向无需预先归一化
+void batchClosestPoint(const Vec3Span& origin, const Vec3Span& dir, const Vec3Span& point,
+                       const Vec3OutSpan& out, size_t count);
+
+// 中点：(p1 + p2) / 2
+void batchMiddlePoint(const Vec3Span& p1, const Vec3Span& p2, const Vec3OutSpan& out, size_t count);
+
+// 角平分方向：normalize(v1 + v2)
+void batchMirror(const Vec3Span& v1, const Vec3Span& v2, const Vec3OutSpan& out, size_t count);
+
+// 当前编译使用的指令集（"SSE"或"scalar"）
+const char* roadKernelPath();
\ No newline at end of file
@@ -0,0 +1,99 @@
+// 弯道几何批量内核微基准：与逐点标量路径对比
+// 用法：RoadKernelsBench [--count N] [--repeat R]
+#include "RoadKernels.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+
+// 批量缓冲（结构数组布局）
+struct SoaBuffer {
+    std::vector<float> x, y, z;
+    explicit SoaBuffer(size_t n) : x(n), y(n), z(n) {}
+    Vec3Span span() const { Vec3Span s = { x.data(), y.data(), z.data() }; return s; }
+    Vec3OutSpan out() { Vec3OutSpan s = { x.data(), y.data(), z.data() }; return s; }
+};
+
+// 逐点标量实现（与CurvedRoadGenerator原有单点函数一致）
+static osg::Vec3 scalarPerpendicular(const osg::Vec3& v, const osg::Vec3& normal) {
+    osg::Vec3 c = v ^ normal;
+    c.normalize();
+    return c;
+}
+
+static osg::Vec3 scalarClosestPoint(const osg::Vec3& origin, const osg::Vec3& dir, const osg::Vec3& point) {
+    float len2 = dir.length2();
+    if(len2 <= 0) return origin;
+    return origin + dir * (((point - origin) * dir) / len2);
+}
+
+static osg::Vec3 scalarMirror(const osg::Vec3& v1, const osg::Vec3& v2) {
+    osg::Vec3 sum = v1 + v2;
+    sum.normalize();
+    return sum;
+}
+
+// 多次运行取最短耗时（毫秒）
+static double bestTime(int repeat, const std::function<void()>& body) {
+    double best = 1e30;
+    for(int r=0; r<repeat; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        body();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+static void report(const char* name, size_t count, double scalarMs, double batchMs) {
+    printf("%-14s 标量 %8.2f ms (%6.1f M/s)  批量 %8.2f ms (%6.1f M/s)  加速 %.2fx\n", name,
+           scalarMs, count / scalarMs / 1e3, batchMs, count / batchMs / 1e3, scalarMs / batchMs);
+}
+
+int main(int argc, char** argv) {
+    size_t count = 4 << 20;
+    int repeat = 5;
+    for(int i=1; i+1<argc; i += 2) {
+        if(strcmp(argv[i], "--count") == 0) count = static_cast<size_t>(atoll(argv[i+1]));
+        else if(strcmp(argv[i], "--repeat") == 0) repeat = std::max(1, atoi(argv[i+1]));
+    }
+
+    // 随机线段（两种布局各存一份）
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-100.0f, 100.0f);
+    std::vector<osg::Vec3> p(count), d(count), q(count), out(count);
+    SoaBuffer P(count), D(count), Q(count), O(count);
+    for(size_t i=0; i<count; ++i) {
+        p[i] = osg::Vec3(dist(rng), dist(rng), dist(rng));
+        d[i] = osg::Vec3(dist(rng), dist(rng), dist(rng));
+        q[i] = osg::Vec3(dist(rng), dist(rng), dist(rng));
+        P.x[i] = p[i].x(); P.y[i] = p[i].y(); P.z[i] = p[i].z();
+        D.x[i] = d[i].x(); D.y[i] = d[i].y(); D.z[i] = d[i].z();
+        Q.x[i] = q[i].x(); Q.y[i] = q[i].y(); Q.z[i] = q[i].z();
+    }
+    const osg::Vec3 normal(0, 0, 1);
+    const float width = 3.5f;
+    printf("内核路径: %s，线段数: %zu\n", roadKernelPath(), count);
+
+    report("offset", count,
+        bestTime(repeat, [&]() { for(size_t i=0; i<count; ++i) out[i] = p[i] + scalarPerpendicular(d[i], normal) * width; }),
+        bestTime(repeat, [&]() { batchOffset(P.span(), D.span(), normal, width, O.out(), count); }));
+    report("closestPoint", count,
+        bestTime(repeat, [&]() { for(size_t i=0; i<count; ++i) out[i] = scalarClosestPoint(p[i], d[i], q[i]); }),
+        bestTime(repeat, [&]() { batchClosestPoint(P.span(), D.span(), Q.span(), O.out(), count); }));
+    report("middlePoint", count,
+        bestTime(repeat, [&]() { for(size_t i=0; i<count; ++i) out[i] = (p[i] + q[i]) * 0.5f; }),
+        bestTime(repeat, [&]() { batchMiddlePoint(P.span(), Q.span(), O.out(), count); }));
+    report("mirror", count,
+        bestTime(repeat, [&]() { for(size_t i=0; i<count; ++i) out[i] = scalarMirror(d[i], q[i]); }),
+        bestTime(repeat, [&]() { batchMirror(D.span(), Q.span(), O.out(), count); }));
+
+    // 输出校验和，防止结果被优化掉
+    double checksum = 0;
+    for(size_t i=0; i<count; i += 4096) checksum += out[i].x() + O.x[i];
+    printf("校验和: %g\n", checksum);
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include "ShapefileReader.h"
+#include <QFileInfo>
+#include <QtEndian>
+#include <cstring>
+
+// 文件头与记录布局常量
+static const int kMainHeaderSize = 100;
+static const int kIndexRecordSize = 8;
+static const int kRecordHeaderSize = 8;
+static const int kPolylineFixedSize = 44;   // 形状类型 + 包围盒 + 部件数 + 点数
+
+// 小端double解码（映射内存不保证对齐）
+static double readDoubleLE(const uchar* p) {
+    quint64 bits = qFromLittleEndian<quint64>(p);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// 查找字段索引（不区分大小写）
+int DbfRecordView::fieldIndex(const char* name) const {
+    if(!fields) return -1;
+    for(size_t i=0; i<fields->size(); ++i) {
+        if(qstricmp((*fields)[i].name.constData(), name) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// 字段原始值（引用映射内存，零拷贝）
+QByteArray DbfRecordView::rawValue(int field) const {
+    if(!data || field < 0 || field >= static_cast<int>(fields->size())) {
+        return QByteArray();
+    }
+    const DbfField& f = (*fields)[field];
+    return QByteArray::fromRawData(reinterpret_cast<const char*>(data + f.offset), f.length).trimmed();
+}
+
+// 数值字段解析
+double DbfRecordView::toDouble(int field, bool* ok) const {
+    return rawValue(field).toDouble(ok);
+}
+
+// 部件起始点索引
+int PolylineView::partBegin(int part) const {
+    return qFromLittleEndian<qint32>(content + kPolylineFixedSize + part*4);
+}
+
+// 部件结束点索引（不含）
+int PolylineView::partEnd(int part) const {
+    return part + 1 < parts ? partBegin(part + 1) : points;
+}
+
+// 解码第i个点
+osg::Vec3d PolylineView::point(int i) const {
+    const uchar* p = content + kPolylineFixedSize + parts*4 + i*16;
+    double z = zValues ? readDoubleLE(zValues + i*8) : 0.0;
+    return osg::Vec3d(readDoubleLE(p), readDoubleLE(p + 8), z);
+}
+
+ShapefileReader::ShapefileReader()
+    : shpData(nullptr), shxData(nullptr), dbfData(nullptr),
+      shpSize(0), shxSize(0), dbfSize(0), type(SHAPE_NULL),
+      numRecords(0), dbfRecordCount(0), dbfHeaderLength(0), dbfRecordLength(0) {
+}
+
+ShapefileReader::~ShapefileReader() {
+    close();
+}
+
+// 打开数据集（可传入.shp路径或不带扩展名的基础路径）
+bool ShapefileReader::open(const QString& path) {
+    close();
+
+    QFileInfo info(path);
+    QString base = info.suffix().compare("shp", Qt::CaseInsensitive) == 0
+        ? info.path() + "/" + info.completeBaseName() : path;
+
+    if(!mapFile(shpFile, base + ".shp", shpData, shpSize) ||
+       !mapFile(shxFile, base + ".shx", shxData, shxSize)) {
+        close();
+        return false;
+    }
+    if(shpSize < kMainHeaderSize || shxSize < kMainHeaderSize ||
+       qFromBigEndian<qint32>(shpData) != 9994) {
+        error = "无效的Shapefile文件头: " + base;
+        close();
+        return false;
+    }
+
+    // 解析主文件头
+    type = static_cast<ShapeType>(qFromLittleEndian<qint32>(shpData + 32));
+    if(type != SHAPE_POLYLINE && type != SHAPE_POLYLINE_Z && type != SHAPE_POLYLINE_M) {
+        error = QString("不支持的几何类型: %1").arg(type);
+        close();
+        return false;
+    }
+    extent.set(readDoubleLE(shpData + 36), readDoubleLE(shpData + 44), readDoubleLE(shpData + 68),
+               readDoubleLE(shpData + 52), readDoubleLE(shpData + 60), readDoubleLE(shpData + 76));
+    numRecords = static_cast<int>((shxSize - kMainHeaderSize) / kIndexRecordSize);
+
+    // 属性表可选
+    if(QFileInfo::exists(base + ".dbf")) {
+        if(!mapFile(dbfFile, base + ".dbf", dbfData, dbfSize) || !parseDbfHeader()) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+// 释放映射并关闭文件
+void ShapefileReader::close() {
+    shpFile.close();
+    shxFile.close();
+    dbfFile.close();
+    shpData = shxData = dbfData = nullptr;
+    shpSize = shxSize = dbfSize = 0;
+    type = SHAPE_NULL;
+    extent.init();
+    numRecords = dbfRecordCount = dbfHeaderLength = dbfRecordLength = 0;
+    dbfFields.clear();
+}
+
+// 只读映射整个文件（由操作系统按页调入）
+bool ShapefileReader::mapFile(QFile& file, const QString& fileName, const uchar*& data, qint64& size) {
+    file.setFileName(fileName);
+    if(!file.open(QIODevice::ReadOnly)) {
+        error = "无法打开文件: " + fileName;
+        return false;
+    }
+    size = file.size();
+    data = size > 0 ? file.map(0, size) : nullptr;
+    if(!data) {
+        error = "无法映射文件: " + fileName;
+        return false;
+    }
+    return true;
+}
+
+// 解析DBF文件头与字段描述
+bool ShapefileReader::parseDbfHeader() {
+    if(dbfSize < 32) {
+        error = "无效的DBF文件头";
+        return false;
+    }
+    dbfRecordCount = qFromLittleEndian<quint32>(dbfData + 4);
+    dbfHeaderLength = qFromLittleEndian<quint16>(dbfData + 8);
+    dbfRecordLength = qFromLittleEndian<quint16>(dbfData + 10);
+    if(dbfHeaderLength > dbfSize) {
+        error = "DBF文件长度不足";
+        return false;
+    }
+
+    int offset = 1; // 跳过删除标记
+    for(int pos = 32; pos + 32 <= dbfHeaderLength && dbfData[pos] != 0x0D; pos += 32) {
+        DbfField field;
+        field.name = QByteArray(reinterpret_cast<const char*>(dbfData + pos), qstrnlen(reinterpret_cast<const char*>(dbfData + pos), 11));
+        field.type = static_cast<char>(dbfData[pos + 11]);
+        field.offset = offset;
+        field.length = dbfData[pos + 16];
+        offset += field.length;
+        if(offset > dbfRecordLength) {
+            error = "DBF字段超出记录长度";
+            return false;
+        }
+        dbfFields.push_back(field);
+    }
+
+    if(static_cast<qint64>(dbfHeaderLength) + static_cast<qint64>(dbfRecordCount) * dbfRecordLength > dbfSize) {
+        error = "DBF文件长度不足";
+        return false;
+    }
+    return true;
+}
+
+// 通过.shx偏移读取单条记录
+bool ShapefileReader::readRecord(int index, PolylineView& shape, DbfRecordView& attributes) const {
+    shape = PolylineView();
+    attributes = DbfRecordView();
+    if(index < 0 || index >= numRecords) return false;
+
+    const uchar* entry = shxData + kMainHeaderSize + static_cast<qint64>(index) * kIndexRecordSize;
+    qint64 offset = static_cast<qint64>(qFromBigEndian<qint32>(entry)) * 2;
+    qint64 length = static_cast<qint64>(qFromBigEndian<qint32>(entry + 4)) * 2;
+    if(offset < kMainHeaderSize || length < 0 || offset + kRecordHeaderSize + length > shpSize) return false;
+
+    const uchar* content = shpData + offset + kRecordHeaderSize;
+    if(index < dbfRecordCount) {
+        attributes = DbfRecordView(dbfData + dbfHeaderLength + static_cast<qint64>(index) * dbfRecordLength, &dbfFields);
+    }
+
+    // 空几何
+    if(length < 4 || qFromLittleEndian<qint32>(content) == SHAPE_NULL) return true;
+    if(length < kPolylineFixedSize) return false;
+
+    int parts = qFromLittleEndian<qint32>(content + 36);
+    int points = qFromLittleEndian<qint32>(content + 40);
+    qint64 xyEnd = kPolylineFixedSize + static_cast<qint64>(parts) * 4 + static_cast<qint64>(points) * 16;
+    if(parts < 0 || points < 0 || xyEnd > length) return false;
+
+    // 部件起点须在 [0, points] 内且单调不减，否则按损坏记录拒绝
+    int previous = 0;
+    for(int part=0; part<parts; ++part) {
+        int begin = qFromLittleEndian<qint32>(content + kPolylineFixedSize + part*4);
+        if(begin < previous || begin > points) return false;
+        previous = begin;
+    }
+
+    shape.content = content;
+    shape.parts = parts;
+    shape.points = points;
+    shape.recordNumber = qFromBigEndian<qint32>(shpData + offset);
+    if(type == SHAPE_POLYLINE_Z && xyEnd + 16 + static_cast<qint64>(points) * 8 <= length) {
+        shape.zValues = content + xyEnd + 16;
+    }
+    return true;
+}
+
+// 流式遍历所有线要素，访问器返回false时提前结束
+int ShapefileReader::forEachPolyline(const PolylineVisitor& visitor) const {
+    PolylineView shape;
+    DbfRecordView attributes;
+    int visited = 0;
+    for(int i=0; i<numRecords; ++i) {
+        if(!readRecord(i, shape, attributes) || !shape.isValid() || attributes.isDeleted()) {
+            continue;
+        }
+        ++visited;
+        if(!visitor(shape, attributes)) break;
+    }
+    return visited;
+}
\ No newline at end of file
@@ -0,0 +1,110 @@
+#pragma once
+#include <osg/Vec3d>
+#include <osg/BoundingBox>
+#include <QFile>
+#include <QString>
+#include <QByteArray>
+#include <vector>
+#include <functional>
+
+// Shapefile几何类型（仅支持线要素）
+enum ShapeType {
+    SHAPE_NULL = 0,
+    SHAPE_POLYLINE = 3,
+    SHAPE_POLYLINE_Z = 13,
+    SHAPE_POLYLINE_M = 23
+};
+
+// DBF字段描述
+struct DbfField {
+    QByteArray name;    // 字段名
+    char type;          // 字段类型（C/N/F/L/D）
+    int offset;         // 记录内偏移（含删除标记字节）
+    int length;         // 字段长度
+};
+
+// DBF记录视图（直接指向映射内存，不复制数据）
+class DbfRecordView {
+public:
+    DbfRecordView() : data(nullptr), fields(nullptr) {}
+    DbfRecordView(const uchar* d, const std::vector<DbfField>* f) : data(d), fields(f) {}
+
+    bool isValid() const { return data != nullptr; }
+    bool isDeleted() const { return data && data[0] == '*'; }
+    int fieldIndex(const char* name) const;
+    QByteArray rawValue(int field) const;
+    double toDouble(int field, bool* ok = nullptr) const;
+
+private:
+    const uchar* data;
+    const std::vector<DbfField>* fields;
+};
+
+// PolyLine记录视图（坐标按需从映射内存解码）
+class PolylineView {
+public:
+    PolylineView() : content(nullptr), zValues(nullptr), parts(0), points(0), recordNumber(0) {}
+
+    bool isValid() const { return content != nullptr; }
+    int record() const { return recordNumber; }
+    int numParts() const { return parts; }
+    int numPoints() const { return points; }
+    int partBegin(int part) const;
+    int partEnd(int part) const;
+    bool hasZ() const { return zValues != nullptr; }
+    osg::Vec3d point(int i) const;
+
+private:
+    friend class ShapefileReader;
+    const uchar* content;   // 记录内容起点（形状类型字段）
+    const uchar* zValues;   // Z值数组（仅PolyLineZ）
+    int parts;
+    int points;
+    int recordNumber;
+};
+
+// 基于内存映射的流式Shapefile读取器
+// 通过.shx索引定位.shp记录，逐条访问而不将整个文件解析到中间容器
+class ShapefileReader {
+public:
+    typedef std::function<bool(const PolylineView&, const DbfRecordView&)> PolylineVisitor;
+
+    ShapefileReader();
+    ~ShapefileReader();
+
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return shpData != nullptr; }
+
+    int recordCount() const { return numRecords; }
+    ShapeType shapeType() const { return type; }
+    const osg::BoundingBoxd& bounds() const { return extent; }
+    const std::vector<DbfField>& attributeFields() const { return dbfFields; }
+    QString errorString() const { return error; }
+
+    bool readRecord(int index, PolylineView& shape, DbfRecordView& attributes) const;
+    int forEachPolyline(const PolylineVisitor& visitor) const;
+
+private:
+    bool mapFile(QFile& file, const QString& fileName, const uchar*& data, qint64& size);
+    bool parseDbfHeader();
+
+    QFile shpFile;
+    QFile shxFile;
+    QFile dbfFile;
+    const uchar* shpData;
+    const uchar* shxData;
+    const uchar* dbfData;
+    qint64 shpSize;
+    qint64 shxSize;
+    qint64 dbfSize;
+
+    ShapeType type;
+    osg::BoundingBoxd extent;
+    int numRecords;
+    int dbfRecordCount;
+    int dbfHeaderLength;
+    int dbfRecordLength;
+    std::vector<DbfField> dbfFields;
+    QString error;
+};
\ No newline at end of file
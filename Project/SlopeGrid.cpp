@@ -0,0 +1,95 @@
+#include "SlopeGrid.h"
+#include <algorithm>
+
+void SlopeGrid::reset(const osg::Vec2& gridOrigin, float size, int numColumns, int numRows,
+                      bool withElevations, float elevation) {
+    origin = gridOrigin;
+    cellSize = size;
+    columns = numColumns > 0 ? numColumns : 0;
+    rows = numRows > 0 ? numRows : 0;
+    defaultElevation = elevation;
+    properties.assign(static_cast<size_t>(columns) * rows, 0);
+    if(withElevations) {
+        elevations.assign(static_cast<size_t>(columns + 1) * (rows + 1), elevation);
+    } else {
+        elevations.clear();
+        elevations.shrink_to_fit();
+    }
+}
+
+// 单元角点（k = 0..3，自左下角起逆时针）
+osg::Vec3 SlopeGrid::corner(int x, int y, int k) const {
+    static const int dx[4] = { 0, 1, 1, 0 };
+    static const int dy[4] = { 0, 0, 1, 1 };
+    return node(x + dx[k], y + dy[k]);
+}
+
+// 单元中心（高程取四角平均）
+osg::Vec3 SlopeGrid::centre(int x, int y) const {
+    float z = 0.25f * (nodeElevation(x, y) + nodeElevation(x + 1, y) +
+                       nodeElevation(x, y + 1) + nodeElevation(x + 1, y + 1));
+    return osg::Vec3(origin.x() + (x + 0.5f) * cellSize, origin.y() + (y + 0.5f) * cellSize, z);
+}
+
+// 由单元四角节点拟合平面（取两对边高差的平均坡度）
+SlopeGrid::CellPlane SlopeGrid::cellPlane(int x, int y, float tolerance) const {
+    const float z00 = nodeElevation(x, y), z10 = nodeElevation(x + 1, y);
+    const float z01 = nodeElevation(x, y + 1), z11 = nodeElevation(x + 1, y + 1);
+    CellPlane plane = { x, y, z00, 0.5f * ((z10 - z00) + (z11 - z01)), 0.5f * ((z01 - z00) + (z11 - z10)), true };
+    plane.valid = nodeOnPlane(plane, x, y, tolerance) && nodeOnPlane(plane, x + 1, y, tolerance) &&
+                  nodeOnPlane(plane, x, y + 1, tolerance) && nodeOnPlane(plane, x + 1, y + 1, tolerance);
+    return plane;
+}
+
+void SlopeGrid::mergeRectangles(std::vector<SlopeRect>& rects, float planeTolerance) const {
+    // 无节点高程时格网处处共面
+    const bool flat = !hasElevations();
+    
+    // 上一行仍可向上延伸的矩形及其平面，按 x0 有序
+    std::vector<SlopeRect> open, next;
+    std::vector<CellPlane> openPlanes, nextPlanes;
+    for(int y=0; y<rows; ++y) {
+        const unsigned char* row = propertyRow(y);
+        next.clear();
+        nextPlanes.clear();
+        size_t k = 0;
+        int x = 0;
+        while(x < columns) {
+            // 当前行的一段游程：同属性且右侧节点仍在首单元平面上
+            CellPlane plane = cellPlane(x, y, planeTolerance);
+            int end = x + 1;
+            while(end < columns && row[end] == row[x] && (flat || (plane.valid &&
+                  nodeOnPlane(plane, end + 1, y, planeTolerance) && nodeOnPlane(plane, end + 1, y + 1, planeTolerance)))) {
+                ++end;
+            }
+
+            // 上一行中起点更靠左的矩形已无法延伸，直接输出
+            while(k < open.size() && open[k].x0 < x) rects.push_back(open[k++]);
+            bool extend = k < open.size() && open[k].x0 == x && open[k].x1 == end && open[k].property == row[x];
+            if(extend && !flat) {
+                // 纵向拼接要求本行顶部节点也在原矩形平面上（底部节点与原矩形共享）
+                const CellPlane& below = openPlanes[k];
+                extend = below.valid && plane.valid;
+                for(int i=x; extend && i<=end; ++i) {
+                    extend = nodeOnPlane(below, i, y + 1, planeTolerance);
+                }
+            }
+            if(extend) {
+                SlopeRect rect = open[k];
+                rect.y1 = y + 1;
+                next.push_back(rect);
+                nextPlanes.push_back(openPlanes[k]);
+                ++k;
+            } else {
+                SlopeRect rect = { x, y, end, y + 1, row[x] };
+                next.push_back(rect);
+                nextPlanes.push_back(plane);
+            }
+            x = end;
+        }
+        rects.insert(rects.end(), open.begin() + k, open.end());
+        open.swap(next);
+        openPlanes.swap(nextPlanes);
+    }
+    rects.insert(rects.end(), open.begin(), open.end());
+}
\ No newline at end of file
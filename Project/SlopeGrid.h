@@ -0,0 +1,72 @@
+#pragma once
+#include <osg/Vec2>
+#include <osg/Vec3>
+#include <cmath>
+#include <vector>
+
+// 同属性单元合并得到的矩形（单元索引，含 x0/y0，不含 x1/y1）
+struct SlopeRect {
+    int x0, y0, x1, y1;
+    unsigned char property;
+};
+
+// 边坡微分单元格网（行优先扁平存储）
+// 单元角点由原点与格网尺寸隐式确定，每个单元只存1字节属性；
+// 可选的节点高程数组由相邻单元共享，(列数+1)*(行数+1)个节点
+class SlopeGrid {
+public:
+    SlopeGrid() : cellSize(1.0f), defaultElevation(0.0f), columns(0), rows(0) {}
+
+    void reset(const osg::Vec2& gridOrigin, float size, int numColumns, int numRows,
+               bool withElevations, float elevation = 0.0f);
+
+    int getNumColumns() const { return columns; }
+    int getNumRows() const { return rows; }
+    float getCellSize() const { return cellSize; }
+    const osg::Vec2& getOrigin() const { return origin; }
+    bool hasElevations() const { return !elevations.empty(); }
+    size_t memoryUsage() const { return properties.size() + elevations.size() * sizeof(float); }
+
+    // 单元属性
+    unsigned char property(int x, int y) const { return properties[static_cast<size_t>(y) * columns + x]; }
+    void setProperty(int x, int y, unsigned char value) { properties[static_cast<size_t>(y) * columns + x] = value; }
+    unsigned char* propertyRow(int y) { return &properties[static_cast<size_t>(y) * columns]; }
+    const unsigned char* propertyRow(int y) const { return &properties[static_cast<size_t>(y) * columns]; }
+
+    // 节点高程（未分配时为统一高程）
+    float nodeElevation(int x, int y) const {
+        return elevations.empty() ? defaultElevation : elevations[static_cast<size_t>(y) * (columns + 1) + x];
+    }
+    float* elevationRow(int y) { return elevations.empty() ? nullptr : &elevations[static_cast<size_t>(y) * (columns + 1)]; }
+    const float* elevationRow(int y) const { return elevations.empty() ? nullptr : &elevations[static_cast<size_t>(y) * (columns + 1)]; }
+
+    // 由索引隐式计算的几何
+    osg::Vec3 node(int x, int y) const {
+        return osg::Vec3(origin.x() + x * cellSize, origin.y() + y * cellSize, nodeElevation(x, y));
+    }
+    osg::Vec3 corner(int x, int y, int k) const;
+    osg::Vec3 centre(int x, int y) const;
+
+    // 贪心矩形合并：逐行游程编码，再与上一行完全相同的游程纵向拼接
+    // 只合并节点高程与矩形首单元平面偏差不超过 planeTolerance 的单元，合并后的矩形按平面绘制不丢失起伏
+    void mergeRectangles(std::vector<SlopeRect>& rects, float planeTolerance) const;
+
+private:
+    // 单元平面：节点索引坐标下 z = z0 + gx*(i - x) + gy*(j - y)
+    struct CellPlane {
+        int x, y;
+        float z0, gx, gy;
+        bool valid;         // 首单元自身在容差内共面
+    };
+    CellPlane cellPlane(int x, int y, float tolerance) const;
+    bool nodeOnPlane(const CellPlane& plane, int i, int j, float tolerance) const {
+        return fabsf(nodeElevation(i, j) - (plane.z0 + plane.gx * (i - plane.x) + plane.gy * (j - plane.y))) <= tolerance;
+    }
+
+    osg::Vec2 origin;                       // 格网原点（左下角）
+    float cellSize;                         // 单元边长
+    float defaultElevation;                 // 无节点高程时的统一高程
+    int columns, rows;                      // 单元列数、行数
+    std::vector<unsigned char> properties;  // 单元属性
+    std::vector<float> elevations;          // 节点高程（可选）
+};
\ No newline at end of file
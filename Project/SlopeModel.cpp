@@ -1,12 +1,18 @@
-#include "SlopeModeling.h"
+#include "SlopeModel.h"
+#include "TextureCache.h"
+#include "TerrainSampler.h"
+#include "SlopeRules.h"
+#include "CrossSectionTemplate.h"
+#include "UnionFind.h"
+#include <algorithm>
+#include <map>
 #include <osg/LineWidth>
-#include <osg/Texture2D>
-#include <osgDB/ReadFile>
-#include <QHBoxLayout>
+#include <cfloat>
+#include <climits>
 #include <cmath>
 
 // 构造函数
-SlopeModeler::SlopeModeler(QWidget* parent) : QMainWindow(parent) {
+SlopeModeler::SlopeModeler(Terrain* sharedTerrain) : terrain(sharedTerrain) {
     // 初始化边坡参数
     params = {
         100.0f,   // baseElevation
@@ -16,116 +22,174 @@ SlopeModeler::SlopeModeler(QWidget* parent) : QMainWindow(parent) {
         2.0f,     // ditchWidth
         1.0f      // gridSize
     };
+    initializeScene();
+}
 
-    // 初始化Qt窗口
-    setGeometry(100, 100, 1200, 800);
-    QWidget* centralWidget = new QWidget(this);
-    QHBoxLayout* layout = new QHBoxLayout(centralWidget);
-    
-    // 初始化OSG场景
-    viewer = new osgViewer::Viewer();
+SlopeModeler::SlopeModeler(const SlopeParameters& parameters, Terrain* sharedTerrain)
+    : terrain(sharedTerrain), params(parameters) {
+    initializeScene();
+}
+
+// 初始化场景与地形
+void SlopeModeler::initializeScene() {
     root = new osg::Group();
-    terrainGeode = new osg::Geode();
+    root->addChild(terrainDisplay.getGeode());
+    gradeline = VerticalAlignment::constant(params.baseElevation);
     
-    // 添加地形（示例使用平面）
-    osg::Geometry* terrain = new osg::Geometry();
-    osg::Vec3Array* terrainVerts = new osg::Vec3Array();
-    for(float x=-50; x<=50; x+=1) {
-        for(float y=-50; y<=50; y+=1) {
-            terrainVerts->push_back(osg::Vec3(x, y, 100 + 5*sin(x/5)*cos(y/5)));
-        }
+    // 未提供共享地形时生成示例地形
+    if(!terrain) {
+        terrain = Terrain::createProcedural(101, 101, osg::Vec3(-50, -50, 0), 1.0f, [](int i, int j) {
+            float x = -50.0f + i;
+            float y = -50.0f + j;
+            return 100 + 5*sin(x/5)*cos(y/5);
+        });
     }
-    terrain->setVertexArray(terrainVerts);
-    terrain->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::POINTS, 0, terrainVerts->size()));
-    terrainGeode->addDrawable(terrain);
-    root->addChild(terrainGeode);
     
-    // 执行算法流程
+    // 默认线路沿X轴穿过地形中部
+    float spacing = terrain->getSpacing();
+    alignment = HorizontalAlignment::straight(
+        terrain->getOrigin() + osg::Vec3(0, terrain->getNumRows() / 2 * spacing, 0),
+        osg::Vec3(1, 0, 0), (terrain->getNumColumns() - 1) * spacing);
+}
+
+// 执行算法流程
+void SlopeModeler::run() {
     computeSlopeRange();
+    
+    // 地形只显示边坡范围包围盒内的瓦片
+    osg::BoundingBox window;
+    for(const auto& pt : intersections) {
+        window.expandBy(pt.point);
+    }
+    terrainDisplay.showWindow(terrain.get(), window);
+    
     gridSegmentation();
     unitClassification();
     build3DBlocks();
     validateAndMerge();
-    
-    // 设置场景数据
-    viewer->setSceneData(root);
-    viewer->realize();
 }
 
 // 步骤1：计算边坡范围
+// 横断面桩距
+static const float kStationInterval = 5.0f;
+
 void SlopeModeler::computeSlopeRange() {
-    // 1.1 创建基本横断面
-    osg::ref_ptr<osg::Geometry> crossSection = createCrossSection(0);
+    // 1.1 编译横断面模板，建立地形求交索引
+    const float extent = 50.0f;     // 横断面单侧范围
+    CrossSectionTemplate section = CrossSectionTemplate::compile(params, extent);
+    intersector.reset(new TerrainIntersector(terrain.get()));
+    TerrainSampler sampler(terrain.get());
     
-    // 1.2 沿纵向推进计算交点
-    for(float offset = 0; offset < 100; offset += 5.0f) {
-        computeIntersections(createCrossSection(offset));
+    // 1.2 沿平面线形逐桩推进，两侧按路基边缘处地面高低选用挖方或填方模板，实例化到复用的缓冲区后求交
+    std::vector<osg::Vec3> crossSection;
+    crossSection.reserve(std::max(section.size(false), section.size(true)));
+    const int stations = static_cast<int>(alignment.length() / kStationInterval) + 1;
+    for(int k=0; k<stations; ++k) {
+        // 桩号处中线位置与水平横向，高程取设计坡度线
+        float chainage = std::min(k * kStationInterval, alignment.length());
+        osg::Vec3 origin = alignment.position(chainage);
+        origin.z() = gradeline.elevation(chainage);
+        osg::Vec3 lateral = alignment.lateral(chainage);
+        lateral.normalize();
+        for(float side : { 1.0f, -1.0f }) {
+            osg::Vec3 edge = origin + lateral * (side * params.ditchWidth);
+            bool fill = sampler.sample(edge.x(), edge.y()) < origin.z();
+            section.instance(fill, origin, lateral * side, crossSection);
+            computeIntersections(crossSection);
+        }
     }
     
     // 1.3 创建拓扑面
     createTopologySurface();
 }
 
-// 创建横断面几何体
-osg::Geometry* SlopeModeler::createCrossSection(float offset) {
-    osg::Geometry* geom = new osg::Geometry();
-    osg::Vec3Array* verts = new osg::Vec3Array();
-    
-    // 计算横断面点（示例简化）
-    float angleRad = osg::DegreesToRadians(params.slopeAngle);
-    float currentHeight = params.baseElevation;
-    
-    for(int i=0; i<=params.stages; ++i) {
-        float platformZ = currentHeight + params.platformWidth * tan(angleRad);
-        verts->push_back(osg::Vec3(offset, -50, currentHeight));
-        verts->push_back(osg::Vec3(offset, 50, platformZ));
-        currentHeight = platformZ;
-    }
-    
-    geom->setVertexArray(verts);
-    geom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::LINE_STRIP, 0, verts->size()));
-    return geom;
-}
-
 // 计算地形交点
-void SlopeModeler::computeIntersections(osg::Geometry* crossSection) {
-    // 获取地形顶点
-    osg::Vec3Array* terrainVerts = dynamic_cast<osg::Vec3Array*>(terrainGeode->getDrawable(0)->asGeometry()->getVertexArray());
-    
-    // 遍历横断面线段
-    osg::Vec3Array* csVerts = dynamic_cast<osg::Vec3Array*>(crossSection->getVertexArray());
-    for(size_t i=0; i<csVerts->size()-1; ++i) {
-        osg::Vec3 p1 = (*csVerts)[i];
-        osg::Vec3 p2 = (*csVerts)[i+1];
-        
-        // 遍历地形三角形（示例简化）
-        for(size_t j=0; j<terrainVerts->size()-2; j+=3) {
-            osg::Vec3 t1 = (*terrainVerts)[j];
-            osg::Vec3 t2 = (*terrainVerts)[j+1];
-            osg::Vec3 t3 = (*terrainVerts)[j+2];
-            
-            // 计算线段与三角形交点（简化实现）
-            osg::Vec3 intersect;
-            if(/* 交点检测逻辑 */) {
-                intersections.push_back({intersect, false});
-            }
+void SlopeModeler::computeIntersections(const std::vector<osg::Vec3>& crossSection) {
+    // 遍历横断面线段，经索引只测试线段经过的地形单元
+    std::vector<TerrainHit> hits;
+    for(size_t i=0; i+1<crossSection.size(); ++i) {
+        hits.clear();
+        intersector->intersectAll(crossSection[i], crossSection[i+1], hits);
+        for(const auto& hit : hits) {
+            intersections.push_back({hit.point, false});
         }
     }
 }
 
-// 创建拓扑面
+// 创建拓扑面：交点投影到平面线形，按（桩号，偏距）排序后逐桩分组，
+// 相邻两桩的交点序列按偏距归并连成三角形；每桩偏距最小、最大的交点为范围边界
 void SlopeModeler::createTopologySurface() {
+    const size_t count = intersections.size();
+    if(count == 0) return;
+    
+    std::vector<float> xs(count), ys(count), chainages(count), offsets(count);
+    for(size_t i=0; i<count; ++i) {
+        xs[i] = intersections[i].point.x();
+        ys[i] = intersections[i].point.y();
+    }
+    alignment.project(xs.data(), ys.data(), chainages.data(), offsets.data(), count);
+    
+    std::vector<size_t> order(count);
+    for(size_t i=0; i<count; ++i) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return chainages[a] != chainages[b] ? chainages[a] < chainages[b] : offsets[a] < offsets[b];
+    });
+    
+    // 按所属横断面分组（交点投影回其横断面桩号），组内保持偏距升序
+    std::vector<std::vector<size_t>> sections;
+    int currentStation = INT_MIN;
+    for(size_t i : order) {
+        int station = static_cast<int>(floorf(chainages[i] / kStationInterval + 0.5f));
+        if(station != currentStation) {
+            sections.push_back(std::vector<size_t>());
+            currentStation = station;
+        }
+        sections.back().push_back(i);
+    }
+    for(auto& section : sections) {
+        std::sort(section.begin(), section.end(), [&](size_t a, size_t b) { return offsets[a] < offsets[b]; });
+        intersections[section.front()].isBoundary = true;
+        intersections[section.back()].isBoundary = true;
+    }
+    
     osg::Geometry* surface = new osg::Geometry();
     osg::Vec3Array* verts = new osg::Vec3Array();
+    std::vector<unsigned int> vertexOf(count);
+    verts->reserve(count);
+    for(const auto& section : sections) {
+        for(size_t i : section) {
+            vertexOf[i] = verts->size();
+            verts->push_back(intersections[i].point);
+        }
+    }
     
-    // 按顺时针排序交点
-    // 此处需要实现凸包算法或排序逻辑
-    for(const auto& pt : intersections) {
-        verts->push_back(pt.point);
+    // 相邻桩两条有序交点序列之间的三角剖分，三角形统一朝上
+    osg::DrawElementsUInt* triangles = new osg::DrawElementsUInt(GL_TRIANGLES);
+    auto addTriangle = [&](size_t a, size_t b, size_t c) {
+        unsigned int ia = vertexOf[a], ib = vertexOf[b], ic = vertexOf[c];
+        osg::Vec3 normal = ((*verts)[ib] - (*verts)[ia]) ^ ((*verts)[ic] - (*verts)[ia]);
+        if(normal.z() < 0) std::swap(ib, ic);
+        triangles->push_back(ia);
+        triangles->push_back(ib);
+        triangles->push_back(ic);
+    };
+    for(size_t k=0; k+1<sections.size(); ++k) {
+        const std::vector<size_t>& a = sections[k];
+        const std::vector<size_t>& b = sections[k+1];
+        size_t i = 0, j = 0;
+        while(i + 1 < a.size() || j + 1 < b.size()) {
+            if(j + 1 == b.size() || (i + 1 < a.size() && offsets[a[i+1]] <= offsets[b[j+1]])) {
+                addTriangle(a[i], a[i+1], b[j]);
+                ++i;
+            } else {
+                addTriangle(a[i], b[j+1], b[j]);
+                ++j;
+            }
+        }
     }
     
     surface->setVertexArray(verts);
-    surface->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::POLYGON, 0, verts->size()));
+    surface->addPrimitiveSet(triangles);
     
     osg::Geode* geode = new osg::Geode();
     geode->addDrawable(surface);
@@ -139,61 +203,32 @@ void SlopeModeler::gridSegmentation() {
     for(const auto& pt : intersections) {
         bb.expandBy(pt.point);
     }
+    if(!bb.valid()) {
+        grid.reset(osg::Vec2(0, 0), params.gridSize, 0, 0, false);
+        return;
+    }
     
-    // 创建格网
+    // 创建格网，单元角点隐式确定，只存属性与共享节点高程
     int xSteps = ceil((bb.xMax() - bb.xMin()) / params.gridSize);
     int ySteps = ceil((bb.yMax() - bb.yMin()) / params.gridSize);
+    grid.reset(osg::Vec2(bb.xMin(), bb.yMin()), params.gridSize, xSteps, ySteps, true, params.baseElevation);
     
-    gridUnits.resize(ySteps, std::vector<MicroUnit>(xSteps));
-    
-    // 填充格网单元
-    for(int y=0; y<ySteps; ++y) {
-        for(int x=0; x<xSteps; ++x) {
-            float x0 = bb.xMin() + x*params.gridSize;
-            float y0 = bb.yMin() + y*params.gridSize;
-            float x1 = x0 + params.gridSize;
-            float y1 = y0 + params.gridSize;
-            
-            // 创建四边形单元（示例简化）
-            gridUnits[y][x] = createMicroUnit(
-                osg::Vec3(x0, y0, 100),
-                osg::Vec3(x1, y0, 100),
-                osg::Vec3(x1, y1, 100),
-                osg::Vec3(x0, y1, 100)
-            );
-        }
+    // 逐行批量采样节点处地面高程
+    TerrainSampler sampler(terrain.get());
+    std::vector<float> xs(xSteps + 1), ys(xSteps + 1);
+    for(int x=0; x<=xSteps; ++x) {
+        xs[x] = bb.xMin() + x*params.gridSize;
+    }
+    for(int y=0; y<=ySteps; ++y) {
+        std::fill(ys.begin(), ys.end(), bb.yMin() + y*params.gridSize);
+        sampler.sample(xs.data(), ys.data(), grid.elevationRow(y), xSteps + 1);
     }
-}
-
-// 创建微分单元
-MicroUnit SlopeModeler::createMicroUnit(const osg::Vec3& v1, const osg::Vec3& v2, 
-                                      const osg::Vec3& v3, const osg::Vec3& v4) {
-    MicroUnit unit;
-    unit.vertices[0] = v1;
-    unit.vertices[1] = v2;
-    unit.vertices[2] = v3;
-    unit.vertices[3] = v4;
-    unit.property = 0; // 默认属性
-    return unit;
 }
 
 // 步骤3：单元分类
 void SlopeModeler::unitClassification() {
-    // 遍历所有单元进行分类
-    for(auto& row : gridUnits) {
-        for(auto& unit : row) {
-            // 计算单元中心点
-            osg::Vec3 center = (unit.vertices[0] + unit.vertices[2]) * 0.5f;
-            
-            // 根据位置判断属性（示例简化）
-            if(center.y() < params.ditchWidth) {
-                unit.property = 1; // 排水沟
-            } else if(center.z() > params.baseElevation + 10) {
-                unit.property = 2; // 一级边坡
-            }
-            // 添加更多分类规则...
-        }
-    }
+    // 规则（排水沟、各级边坡、平台）预先编译为阈值，按行并行分类
+    classifySlopeGrid(SlopeRuleSet::compile(params), alignment, gradeline, grid);
 }
 
 // 步骤4：构建三维体块
@@ -202,72 +237,340 @@ void SlopeModeler::build3DBlocks() {
     mergeAdjacentUnits();
     
     // 创建三维体块
-    for(const auto& block : slopeBlocks) {
-        osg::Geode* geode = new osg::Geode();
-        geode->addDrawable(block.geometry.get());
+    for(auto& block : slopeBlocks) {
+        block.geode = new osg::Geode();
+        block.geode->addDrawable(block.geometry.get());
         applyTexture(block.geometry.get(), block.property);
-        root->addChild(geode);
+        root->addChild(block.geode.get());
     }
 }
 
 // 合并相邻单元
 void SlopeModeler::mergeAdjacentUnits() {
-    // 实现基于空间索引的合并算法
-    // 此处需要实现四叉树或网格索引加速查找
-    for(int y=0; y<gridUnits.size()-1; ++y) {
-        for(int x=0; x<gridUnits[y].size()-1; ++x) {
-            // 查找相邻相同属性单元
-            if(gridUnits[y][x].property == gridUnits[y][x+1].property) {
-                // 合并为更大单元
-                MicroUnit merged = createMicroUnit(
-                    gridUnits[y][x].vertices[0],
-                    gridUnits[y][x+1].vertices[1],
-                    gridUnits[y][x+1].vertices[2],
-                    gridUnits[y][x].vertices[3]
-                );
-                merged.property = gridUnits[y][x].property;
-                // 添加到体块集合...
+    // 同属性且在容差内共面的单元贪心合并为矩形
+    const float planeTolerance = 0.02f;  // 共面容差（米）
+    std::vector<SlopeRect> rects;
+    grid.mergeRectangles(rects, planeTolerance);
+    
+    // 每个连通区域输出一个体块：同属性且共享一段边的矩形属于同一区域
+    // 各行覆盖的矩形按 x0 排序，同行左右相接、相邻两行区间重叠即相邻
+    std::vector<std::vector<int>> rowRects(grid.getNumRows());
+    for(size_t r=0; r<rects.size(); ++r) {
+        if(rects[r].property == SLOPE_NONE) continue;
+        for(int y=rects[r].y0; y<rects[r].y1; ++y) rowRects[y].push_back(static_cast<int>(r));
+    }
+    auto byX = [&](int a, int b) { return rects[a].x0 < rects[b].x0; };
+    for(auto& row : rowRects) std::sort(row.begin(), row.end(), byX);
+    UnionFind regions(rects.size());
+    for(size_t y=0; y<rowRects.size(); ++y) {
+        const std::vector<int>& row = rowRects[y];
+        for(size_t i=0; i+1<row.size(); ++i) {
+            const SlopeRect& a = rects[row[i]];
+            const SlopeRect& b = rects[row[i+1]];
+            if(a.x1 == b.x0 && a.property == b.property) regions.unite(row[i], row[i+1]);
+        }
+        if(y + 1 == rowRects.size()) continue;
+        const std::vector<int>& above = rowRects[y + 1];
+        for(size_t i=0, j=0; i<row.size() && j<above.size();) {
+            const SlopeRect& a = rects[row[i]];
+            const SlopeRect& b = rects[above[j]];
+            if(std::max(a.x0, b.x0) < std::min(a.x1, b.x1) && a.property == b.property) regions.unite(row[i], above[j]);
+            if(a.x1 < b.x1) ++i; else ++j;
+        }
+    }
+    std::map<int, std::vector<const SlopeRect*>> byRegion;
+    for(size_t r=0; r<rects.size(); ++r) {
+        if(rects[r].property != SLOPE_NONE) byRegion[regions.find(static_cast<int>(r))].push_back(&rects[r]);
+    }
+    
+    const float tile = 5.0f; // 纹理重复尺寸
+    std::vector<osg::Vec3> ring;
+    for(const auto& group : byRegion) {
+        osg::Geometry* geom = new osg::Geometry();
+        osg::Vec3Array* verts = new osg::Vec3Array();
+        osg::Vec3Array* norms = new osg::Vec3Array();
+        osg::Vec2Array* texCoords = new osg::Vec2Array();
+        osg::DrawElementsUInt* triangles = new osg::DrawElementsUInt(GL_TRIANGLES);
+        
+        for(const SlopeRect* rect : group.second) {
+            // 边界取矩形四边上的全部格网节点（逆时针），相邻矩形在共享边上顶点一致，不产生T形裂缝
+            ring.clear();
+            for(int x=rect->x0; x<rect->x1; ++x) ring.push_back(grid.node(x, rect->y0));
+            for(int y=rect->y0; y<rect->y1; ++y) ring.push_back(grid.node(rect->x1, y));
+            for(int x=rect->x1; x>rect->x0; --x) ring.push_back(grid.node(x, rect->y1));
+            for(int y=rect->y1; y>rect->y0; --y) ring.push_back(grid.node(rect->x0, y));
+            
+            osg::Vec3 corners[4] = {
+                grid.node(rect->x0, rect->y0), grid.node(rect->x1, rect->y0),
+                grid.node(rect->x1, rect->y1), grid.node(rect->x0, rect->y1)
+            };
+            osg::Vec3 normal = (corners[2] - corners[0]) ^ (corners[3] - corners[1]);
+            normal.normalize();
+            
+            // 单个单元直接输出两个三角形；多单元矩形自中心点扇形三角化（矩形在容差内共面）
+            unsigned int base = verts->size();
+            if(ring.size() > 4) {
+                osg::Vec3 centre = (corners[0] + corners[1] + corners[2] + corners[3]) * 0.25f;
+                ring.insert(ring.begin(), centre);
+            }
+            for(const auto& vertex : ring) {
+                verts->push_back(vertex);
+                norms->push_back(normal);
+                texCoords->push_back(osg::Vec2(vertex.x() / tile, vertex.y() / tile));
+            }
+            if(ring.size() == 4) {
+                const unsigned int indices[6] = { 0, 1, 2, 0, 2, 3 };
+                for(unsigned int index : indices) {
+                    triangles->push_back(base + index);
+                }
+            } else {
+                const unsigned int boundary = ring.size() - 1;
+                for(unsigned int i=0; i<boundary; ++i) {
+                    triangles->push_back(base);
+                    triangles->push_back(base + 1 + i);
+                    triangles->push_back(base + 1 + (i + 1) % boundary);
+                }
             }
         }
+        
+        geom->setVertexArray(verts);
+        geom->setNormalArray(norms, osg::Array::BIND_PER_VERTEX);
+        geom->setTexCoordArray(0, texCoords);
+        geom->addPrimitiveSet(triangles);
+        slopeBlocks.push_back({ geom, group.second.front()->property, nullptr });
     }
 }
 
 // 应用纹理
 void SlopeModeler::applyTexture(osg::Geometry* geom, int property) {
-    osg::Texture2D* texture = new osg::Texture2D();
-    switch(property) {
-        case 1: texture->setImage(osgDB::readImageFile("ditch.png")); break;
-        case 2: texture->setImage(osgDB::readImageFile("slope1.png")); break;
-        // 添加更多纹理...
+    MaterialType material = MATERIAL_DEFAULT;
+    if(property == SLOPE_DITCH) {
+        material = MATERIAL_DITCH;
+    } else if(isSlopeStage(property)) {
+        material = MATERIAL_SLOPE;
+    } else if(isSlopePlatform(property)) {
+        material = MATERIAL_CONCRETE;
     }
     
-    osg::StateSet* stateset = geom->getOrCreateStateSet();
-    stateset->setTextureAttributeAndModes(0, texture, osg::StateAttribute::ON);
+    // 同种属性的体块共享同一个状态集
+    geom->setStateSet(TextureCache::instance().getStateSet(material));
 }
 
-// 步骤5：验证合并
-void SlopeModeler::validateAndMerge() {
-    // 实现相邻面距离计算
-    // 遍历所有体块进行合并
-    for(auto it1 = slopeBlocks.begin(); it1 != slopeBlocks.end(); ++it1) {
-        for(auto it2 = std::next(it1); it2 != slopeBlocks.end(); ) {
-            // 计算面间距离
-            float distance = /* 计算逻辑 */;
-            if(distance < 0.1f) {
-                // 合并体块
-                it1->geometry->addPrimitiveSet(it2->geometry->getPrimitiveSet(0));
-                it2 = slopeBlocks.erase(it2);
-            } else {
-                ++it2;
+// 体块三角形
+struct BlockTriangle {
+    osg::Vec3 v[3];
+    osg::BoundingBox box;
+};
+
+// 提取几何体中的三角形（三角形列表与三角带）
+static void collectTriangles(osg::Geometry* geom, std::vector<BlockTriangle>& triangles) {
+    const osg::Vec3Array* verts = dynamic_cast<const osg::Vec3Array*>(geom->getVertexArray());
+    if(!verts) return;
+    for(unsigned int p=0; p<geom->getNumPrimitiveSets(); ++p) {
+        const osg::PrimitiveSet* set = geom->getPrimitiveSet(p);
+        const unsigned int count = set->getNumIndices();
+        const bool strip = set->getMode() == GL_TRIANGLE_STRIP;
+        if(!strip && set->getMode() != GL_TRIANGLES) continue;
+        for(unsigned int i=0; i+2<count; i += strip ? 1 : 3) {
+            BlockTriangle tri;
+            for(int k=0; k<3; ++k) {
+                tri.v[k] = (*verts)[set->index(i + k)];
+                tri.box.expandBy(tri.v[k]);
             }
+            triangles.push_back(tri);
+        }
+    }
+}
+
+// 点到三角形的最近点
+static osg::Vec3 closestPointOnTriangle(const osg::Vec3& p, const osg::Vec3& a, const osg::Vec3& b, const osg::Vec3& c) {
+    osg::Vec3 ab = b - a, ac = c - a, ap = p - a;
+    float d1 = ab * ap, d2 = ac * ap;
+    if(d1 <= 0 && d2 <= 0) return a;
+    osg::Vec3 bp = p - b;
+    float d3 = ab * bp, d4 = ac * bp;
+    if(d3 >= 0 && d4 <= d3) return b;
+    float vc = d1 * d4 - d3 * d2;
+    if(vc <= 0 && d1 >= 0 && d3 <= 0) return a + ab * (d1 / (d1 - d3));
+    osg::Vec3 cp = p - c;
+    float d5 = ab * cp, d6 = ac * cp;
+    if(d6 >= 0 && d5 <= d6) return c;
+    float vb = d5 * d2 - d1 * d6;
+    if(vb <= 0 && d2 >= 0 && d6 <= 0) return a + ac * (d2 / (d2 - d6));
+    float va = d3 * d6 - d5 * d4;
+    if(va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) return b + (c - b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+    float denom = 1.0f / (va + vb + vc);
+    return a + ab * (vb * denom) + ac * (vc * denom);
+}
+
+// 两线段间最短距离
+static float segmentDistance(const osg::Vec3& p1, const osg::Vec3& q1, const osg::Vec3& p2, const osg::Vec3& q2) {
+    osg::Vec3 d1 = q1 - p1, d2 = q2 - p2, r = p1 - p2;
+    float a = d1 * d1, e = d2 * d2, f = d2 * r;
+    float s = 0.0f, t = 0.0f;
+    if(a <= 1e-12f && e <= 1e-12f) return r.length();
+    if(a <= 1e-12f) {
+        t = osg::clampBetween(f / e, 0.0f, 1.0f);
+    } else {
+        float c = d1 * r;
+        if(e <= 1e-12f) {
+            s = osg::clampBetween(-c / a, 0.0f, 1.0f);
+        } else {
+            float b = d1 * d2;
+            float denom = a * e - b * b;
+            s = denom > 0 ? osg::clampBetween((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if(t < 0) {
+                t = 0;
+                s = osg::clampBetween(-c / a, 0.0f, 1.0f);
+            } else if(t > 1) {
+                t = 1;
+                s = osg::clampBetween((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+    return ((p1 + d1 * s) - (p2 + d2 * t)).length();
+}
+
+// 三角形间最短距离：相交为0，否则最近点对必在顶点-面或边-边之间
+static float triangleDistance(const BlockTriangle& a, const BlockTriangle& b) {
+    float t;
+    for(int i=0; i<3; ++i) {
+        const osg::Vec3& p = a.v[i];
+        const osg::Vec3& q = a.v[(i + 1) % 3];
+        if(intersectSegmentTriangle(p, q - p, b.v[0], b.v[1], b.v[2], t)) return 0.0f;
+        const osg::Vec3& r = b.v[i];
+        const osg::Vec3& w = b.v[(i + 1) % 3];
+        if(intersectSegmentTriangle(r, w - r, a.v[0], a.v[1], a.v[2], t)) return 0.0f;
+    }
+    float best = FLT_MAX;
+    for(int i=0; i<3; ++i) {
+        best = std::min(best, (closestPointOnTriangle(a.v[i], b.v[0], b.v[1], b.v[2]) - a.v[i]).length());
+        best = std::min(best, (closestPointOnTriangle(b.v[i], a.v[0], a.v[1], a.v[2]) - b.v[i]).length());
+        for(int j=0; j<3; ++j) {
+            best = std::min(best, segmentDistance(a.v[i], a.v[(i + 1) % 3], b.v[j], b.v[(j + 1) % 3]));
+        }
+    }
+    return best;
+}
+
+// 两包围盒在各轴上的间隙是否都不超过容差
+static bool boxesWithin(const osg::BoundingBox& a, const osg::BoundingBox& b, float tolerance) {
+    return a.xMin() <= b.xMax() + tolerance && b.xMin() <= a.xMax() + tolerance &&
+           a.yMin() <= b.yMax() + tolerance && b.yMin() <= a.yMax() + tolerance &&
+           a.zMin() <= b.zMax() + tolerance && b.zMin() <= a.zMax() + tolerance;
+}
+
+// 两体块面间距离（达到容差以内即提前返回）
+// 三角形按包围盒X下界排序后扫描，只对包围盒在容差内重叠的三角形对计算距离
+static float blockDistance(const std::vector<BlockTriangle>& a, const std::vector<BlockTriangle>& b, float tolerance) {
+    struct Entry { float xMin; int block; size_t index; };
+    std::vector<Entry> entries;
+    entries.reserve(a.size() + b.size());
+    for(size_t i=0; i<a.size(); ++i) entries.push_back({ a[i].box.xMin(), 0, i });
+    for(size_t i=0; i<b.size(); ++i) entries.push_back({ b[i].box.xMin(), 1, i });
+    std::sort(entries.begin(), entries.end(), [](const Entry& l, const Entry& r) { return l.xMin < r.xMin; });
+    
+    float best = FLT_MAX;
+    std::vector<size_t> active[2];
+    for(const auto& entry : entries) {
+        const std::vector<BlockTriangle>& own = entry.block == 0 ? a : b;
+        const std::vector<BlockTriangle>& other = entry.block == 0 ? b : a;
+        const BlockTriangle& tri = own[entry.index];
+        // 移出X上界已落后于当前三角形的活动项
+        std::vector<size_t>& candidates = active[1 - entry.block];
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](size_t k) {
+            return other[k].box.xMax() + tolerance < tri.box.xMin();
+        }), candidates.end());
+        for(size_t k : candidates) {
+            if(!boxesWithin(tri.box, other[k].box, tolerance)) continue;
+            best = std::min(best, triangleDistance(tri, other[k]));
+            if(best < tolerance) return best;
+        }
+        active[entry.block].push_back(entry.index);
+    }
+    return best;
+}
+
+// 将几何体追加到目标几何体，索引按顶点偏移量平移
+static void appendGeometry(osg::Geometry* target, osg::Geometry* source) {
+    osg::Vec3Array* verts = dynamic_cast<osg::Vec3Array*>(target->getVertexArray());
+    osg::Vec3Array* sourceVerts = dynamic_cast<osg::Vec3Array*>(source->getVertexArray());
+    if(!verts || !sourceVerts) return;
+    const unsigned int offset = verts->size();
+    verts->insert(verts->end(), sourceVerts->begin(), sourceVerts->end());
+    
+    osg::Vec3Array* norms = dynamic_cast<osg::Vec3Array*>(target->getNormalArray());
+    osg::Vec3Array* sourceNorms = dynamic_cast<osg::Vec3Array*>(source->getNormalArray());
+    if(norms && sourceNorms) norms->insert(norms->end(), sourceNorms->begin(), sourceNorms->end());
+    osg::Vec2Array* texCoords = dynamic_cast<osg::Vec2Array*>(target->getTexCoordArray(0));
+    osg::Vec2Array* sourceTexCoords = dynamic_cast<osg::Vec2Array*>(source->getTexCoordArray(0));
+    if(texCoords && sourceTexCoords) texCoords->insert(texCoords->end(), sourceTexCoords->begin(), sourceTexCoords->end());
+    
+    // 复制全部图元集合
+    for(unsigned int p=0; p<source->getNumPrimitiveSets(); ++p) {
+        const osg::PrimitiveSet* set = source->getPrimitiveSet(p);
+        osg::DrawElementsUInt* elements = new osg::DrawElementsUInt(set->getMode());
+        elements->reserve(set->getNumIndices());
+        for(unsigned int i=0; i<set->getNumIndices(); ++i) {
+            elements->push_back(set->index(i) + offset);
         }
+        target->addPrimitiveSet(elements);
     }
+    target->dirtyDisplayList();
+    target->dirtyBound();
 }
 
-// Qt主函数
-int main(int argc, char** argv) {
-    QApplication app(argc, argv);
-    SlopeModeler window;
-    window.show();
-    return app.exec();
+// 步骤5：验证合并
+// 体块按4邻接连通区域生成；同属性区域之间面距离在容差以内（仅角点相接或隔窄缝相邻）时合并为一个体块
+void SlopeModeler::validateAndMerge() {
+    const float tolerance = 0.1f;   // 面间距离合并阈值
+    const size_t count = slopeBlocks.size();
+    if(count < 2) return;
+    
+    // 各体块三角形与包围盒
+    std::vector<std::vector<BlockTriangle>> triangles(count);
+    std::vector<osg::BoundingBox> boxes(count);
+    std::vector<size_t> order(count);
+    for(size_t i=0; i<count; ++i) {
+        collectTriangles(slopeBlocks[i].geometry.get(), triangles[i]);
+        for(const auto& tri : triangles[i]) boxes[i].expandBy(tri.box);
+        order[i] = i;
+    }
+    
+    // 包围盒沿X轴扫描裁剪，得到候选相邻体块，再计算面间距离
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return boxes[a].xMin() < boxes[b].xMin(); });
+    UnionFind sets(count);
+    std::vector<size_t> active;
+    for(size_t i : order) {
+        if(!boxes[i].valid()) continue;
+        active.erase(std::remove_if(active.begin(), active.end(), [&](size_t k) {
+            return boxes[k].xMax() + tolerance < boxes[i].xMin();
+        }), active.end());
+        for(size_t k : active) {
+            // 不同属性的体块材质不同，不合并
+            if(slopeBlocks[k].property != slopeBlocks[i].property) continue;
+            if(!boxesWithin(boxes[i], boxes[k], tolerance)) continue;
+            if(sets.find(i) == sets.find(k)) continue;
+            if(blockDistance(triangles[i], triangles[k], tolerance) < tolerance) {
+                sets.unite(static_cast<int>(i), static_cast<int>(k));
+            }
+        }
+        active.push_back(i);
+    }
+    
+    // 批量合并：每个集合并入编号最小的体块，被合并体块移出场景
+    std::vector<bool> merged(count, false);
+    for(size_t i=0; i<count; ++i) {
+        size_t target = sets.find(static_cast<int>(i));
+        if(target == i) continue;
+        appendGeometry(slopeBlocks[target].geometry.get(), slopeBlocks[i].geometry.get());
+        if(slopeBlocks[i].geode.valid()) root->removeChild(slopeBlocks[i].geode.get());
+        merged[i] = true;
+    }
+    size_t kept = 0;
+    for(size_t i=0; i<count; ++i) {
+        if(!merged[i]) slopeBlocks[kept++] = slopeBlocks[i];
+    }
+    slopeBlocks.resize(kept);
 }
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 #include <osg/Geode>
 #include <osg/Geometry>
-#include <osgViewer/Viewer>
-#include <QMainWindow>
+#include "Terrain.h"
+#include "TerrainDisplay.h"
+#include "Alignment.h"
+#include "TerrainIntersector.h"
+#include "SlopeGrid.h"
+#include <memory>
 #include <vector>
 
 // 边坡参数结构体
@@ -21,22 +25,22 @@ struct IntersectionPoint {
     bool isBoundary;
 };
 
-// 微分单元结构体
-struct MicroUnit {
-    osg::Vec3 vertices[4];  // 四个顶点坐标
-    int property;           // 属性标识
-};
-
 // 三维体块结构体
 struct SlopeBlock {
     osg::ref_ptr<osg::Geometry> geometry;
     int property;
+    osg::ref_ptr<osg::Geode> geode;     // 所在场景节点
 };
 
-class SlopeModeler : public QMainWindow {
-    Q_OBJECT
+// 边坡建模引擎（不依赖窗口，可在无显示环境下运行）
+class SlopeModeler {
 public:
-    SlopeModeler(QWidget* parent = nullptr);
+    explicit SlopeModeler(Terrain* sharedTerrain = nullptr);
+    SlopeModeler(const SlopeParameters& parameters, Terrain* sharedTerrain = nullptr);
+    osg::Group* getRoot() const { return root.get(); }
+    void setAlignment(const HorizontalAlignment& route) { alignment = route; }
+    void setGradeline(const VerticalAlignment& profile) { gradeline = profile; }
+    void run();
     void initializeScene();
     void computeSlopeRange();
     void gridSegmentation();
@@ -46,22 +50,22 @@ public:
 
 private:
     // OSG场景组件
-    osg::ref_ptr<osgViewer::Viewer> viewer;
     osg::ref_ptr<osg::Group> root;
-    osg::ref_ptr<osg::Geode> terrainGeode;
+    TerrainDisplay terrainDisplay;  // 边坡范围内的地形显示网格
+    osg::ref_ptr<Terrain> terrain;
     
     // 算法中间数据
     SlopeParameters params;
+    HorizontalAlignment alignment;  // 平面线形（横断面沿其桩号布置）
+    VerticalAlignment gradeline;    // 设计坡度线
+    std::unique_ptr<TerrainIntersector> intersector;   // 地形求交索引
     std::vector<IntersectionPoint> intersections;
-    std::vector<std::vector<MicroUnit>> gridUnits;
+    SlopeGrid grid;                 // 微分单元格网
     std::vector<SlopeBlock> slopeBlocks;
 
     // 辅助函数
-    osg::Geometry* createCrossSection(float offset);
-    void computeIntersections(osg::Geometry* crossSection);
+    void computeIntersections(const std::vector<osg::Vec3>& crossSection);
     void createTopologySurface();
-    MicroUnit createMicroUnit(const osg::Vec3& v1, const osg::Vec3& v2, 
-                            const osg::Vec3& v3, const osg::Vec3& v4);
     void mergeAdjacentUnits();
     void applyTexture(osg::Geometry* geom, int property);
 };
\ No newline at end of file
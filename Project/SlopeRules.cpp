@@ -0,0 +1,160 @@
+#include "SlopeRules.h"
+#include "SlopeModel.h"
+#include "Parallel.h"
+#include <osg/Math>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SLOPE_KERNEL_SIMD 1
+typedef __m256 simd_t;
+static const size_t kLanes = 8;
+static inline simd_t vload(const float* p) { return _mm256_loadu_ps(p); }
+static inline simd_t vset(float s) { return _mm256_set1_ps(s); }
+static inline simd_t vadd(simd_t a, simd_t b) { return _mm256_add_ps(a, b); }
+static inline simd_t vsub(simd_t a, simd_t b) { return _mm256_sub_ps(a, b); }
+static inline simd_t vmul(simd_t a, simd_t b) { return _mm256_mul_ps(a, b); }
+static inline simd_t vabs(simd_t a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), a); }
+static inline simd_t vgt(simd_t a, simd_t b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+static inline simd_t vle(simd_t a, simd_t b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+static inline simd_t vlt(simd_t a, simd_t b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+static inline simd_t vand(simd_t a, simd_t b) { return _mm256_and_ps(a, b); }
+static inline simd_t vselect(simd_t mask, simd_t a, simd_t b) { return _mm256_blendv_ps(b, a, mask); }
+// 属性值转为字节写出
+static inline void vstoreBytes(unsigned char* p, simd_t v) {
+    __m256i i = _mm256_cvttps_epi32(v);
+    __m128i w = _mm_packs_epi32(_mm256_castsi256_si128(i), _mm256_extracti128_si256(i, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(p), _mm_packus_epi16(w, w));
+}
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SLOPE_KERNEL_SIMD 1
+typedef __m128 simd_t;
+static const size_t kLanes = 4;
+static inline simd_t vload(const float* p) { return _mm_loadu_ps(p); }
+static inline simd_t vset(float s) { return _mm_set1_ps(s); }
+static inline simd_t vadd(simd_t a, simd_t b) { return _mm_add_ps(a, b); }
+static inline simd_t vsub(simd_t a, simd_t b) { return _mm_sub_ps(a, b); }
+static inline simd_t vmul(simd_t a, simd_t b) { return _mm_mul_ps(a, b); }
+static inline simd_t vabs(simd_t a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline simd_t vgt(simd_t a, simd_t b) { return _mm_cmpgt_ps(a, b); }
+static inline simd_t vle(simd_t a, simd_t b) { return _mm_cmple_ps(a, b); }
+static inline simd_t vlt(simd_t a, simd_t b) { return _mm_cmplt_ps(a, b); }
+static inline simd_t vand(simd_t a, simd_t b) { return _mm_and_ps(a, b); }
+static inline simd_t vselect(simd_t mask, simd_t a, simd_t b) {
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+static inline void vstoreBytes(unsigned char* p, simd_t v) {
+    __m128i i = _mm_cvttps_epi32(v);
+    __m128i w = _mm_packs_epi32(i, i);
+    int bytes = _mm_cvtsi128_si32(_mm_packus_epi16(w, w));
+    memcpy(p, &bytes, 4);
+}
+#endif
+
+// 边坡级数上限（属性编码连同填方标志位不超过一个字节）
+static const int kMaxStages = 63;
+
+SlopeRuleSet SlopeRuleSet::compile(const SlopeParameters& params) {
+    // 每级高度与横断面一致：平台宽度乘坡率
+    const float slope = tanf(osg::DegreesToRadians(params.slopeAngle));
+    SlopeRuleSet rules;
+    rules.ditchEdge = params.ditchWidth;
+    rules.stageRise = std::max(params.platformWidth * slope, 1e-6f);
+    // 平台为水平面：单元中心在分级高程上下半个单元坡面落差之内即视为平台
+    rules.platformBand = 0.5f * params.gridSize * slope;
+    rules.stages = osg::clampBetween(params.stages, 0, kMaxStages);
+    return rules;
+}
+
+void classifySlopeRow(const SlopeRuleSet& rules, const float* offset, const float* below, const float* above,
+                      const float* base, unsigned char* out, size_t count) {
+    const float rise = rules.stageRise;
+    const float band = rules.platformBand;
+    size_t i = 0;
+#ifdef SLOPE_KERNEL_SIMD
+    const simd_t quarter = vset(0.25f);
+    const simd_t zero = vset(0.0f);
+    const simd_t fillBit = vset(static_cast<float>(SLOPE_FILL));
+    const simd_t ditchEdge = vset(rules.ditchEdge);
+    for(; i + kLanes <= count; i += kLanes) {
+        // 单元中心高程相对设计高程的高差，按绝对值分级
+        simd_t z = vmul(quarter, vadd(vadd(vload(below + i), vload(below + i + 1)),
+                                      vadd(vload(above + i), vload(above + i + 1))));
+        simd_t h = vsub(z, vload(base + i));
+        simd_t a = vabs(h);
+        simd_t code = zero;
+        for(int k=1; k<=rules.stages; ++k) {
+            simd_t in = vand(vgt(a, vset((k - 1) * rise)), vle(a, vset(k * rise)));
+            code = vselect(in, vset(2.0f * k), code);
+        }
+        for(int k=1; k<rules.stages; ++k) {
+            simd_t platform = vlt(vabs(vsub(a, vset(k * rise))), vset(band));
+            code = vselect(platform, vset(2.0f * k + 1), code);
+        }
+        // 填方置标志位；挖方（含零高差）距中线在沟宽内为排水沟
+        simd_t fill = vlt(h, zero);
+        code = vselect(vand(fill, vgt(code, zero)), vadd(code, fillBit), code);
+        simd_t ditch = vand(vlt(vabs(vload(offset + i)), ditchEdge), vle(zero, h));
+        code = vselect(ditch, vset(SLOPE_DITCH), code);
+        vstoreBytes(out + i, code);
+    }
+#endif
+    for(; i<count; ++i) {
+        float z = 0.25f * (below[i] + below[i+1] + above[i] + above[i+1]);
+        float h = z - base[i];
+        float a = fabsf(h);
+        int code = SLOPE_NONE;
+        for(int k=1; k<=rules.stages; ++k) {
+            code = (a > (k - 1) * rise && a <= k * rise) ? 2 * k : code;
+        }
+        for(int k=1; k<rules.stages; ++k) {
+            code = fabsf(a - k * rise) < band ? 2 * k + 1 : code;
+        }
+        if(h < 0 && code != SLOPE_NONE) code |= SLOPE_FILL;
+        if(fabsf(offset[i]) < rules.ditchEdge && h >= 0) code = SLOPE_DITCH;
+        out[i] = static_cast<unsigned char>(code);
+    }
+}
+
+void classifySlopeGrid(const SlopeRuleSet& rules, const HorizontalAlignment& alignment,
+                       const VerticalAlignment& gradeline, SlopeGrid& grid, int threadCount) {
+    const int columns = grid.getNumColumns();
+    const int rows = grid.getNumRows();
+    if(columns == 0 || rows == 0) return;
+
+    // 未保存节点高程时使用统一高程
+    std::vector<float> flat;
+    if(!grid.hasElevations()) flat.assign(columns + 1, grid.nodeElevation(0, 0));
+
+    // 各列单元中心X坐标整幅格网共用
+    std::vector<float> xs(columns);
+    for(int x=0; x<columns; ++x) {
+        xs[x] = grid.getOrigin().x() + (x + 0.5f) * grid.getCellSize();
+    }
+
+    // 各行写入互不重叠的属性；整行单元中心批量投影到平面线形并求设计高程
+    parallelFor(rows, threadCount, [&](size_t row) {
+        const int y = static_cast<int>(row);
+        const float* below = grid.hasElevations() ? grid.elevationRow(y) : flat.data();
+        const float* above = grid.hasElevations() ? grid.elevationRow(y + 1) : flat.data();
+        std::vector<float> ys(columns, grid.getOrigin().y() + (y + 0.5f) * grid.getCellSize());
+        std::vector<float> chainages(columns), offsets(columns), base(columns);
+        alignment.project(xs.data(), ys.data(), chainages.data(), offsets.data(), columns);
+        gradeline.evaluate(chainages.data(), base.data(), columns);
+        classifySlopeRow(rules, offsets.data(), below, above, base.data(), grid.propertyRow(y), columns);
+    });
+}
+
+const char* slopeKernelPath() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(SLOPE_KERNEL_SIMD)
+    return "SSE";
+#else
+    return "scalar";
+#endif
+}
\ No newline at end of file
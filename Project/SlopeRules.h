@@ -0,0 +1,48 @@
+#pragma once
+#include "SlopeGrid.h"
+#include "Alignment.h"
+#include <cstddef>
+
+struct SlopeParameters;
+
+// 单元属性编码
+// 0 为未分类，1 为排水沟；第k级挖方边坡为 2k，其顶部平台为 2k+1；填方在对应编码上置 SLOPE_FILL 位
+enum SlopeProperty {
+    SLOPE_NONE = 0,
+    SLOPE_DITCH = 1,
+    SLOPE_FIRST_STAGE = 2,
+    SLOPE_FILL = 0x80
+};
+
+inline bool isSlopeFill(int property) { return (property & SLOPE_FILL) != 0; }
+inline bool isSlopeStage(int property) {
+    int code = property & ~SLOPE_FILL;
+    return code >= SLOPE_FIRST_STAGE && code % 2 == 0;
+}
+inline bool isSlopePlatform(int property) {
+    int code = property & ~SLOPE_FILL;
+    return code > SLOPE_FIRST_STAGE && code % 2 == 1;
+}
+
+// 编译后的分类规则：由边坡参数一次性换算出阈值，分类内核只做比较与选择
+struct SlopeRuleSet {
+    float ditchEdge;        // 挖方中单元中心距中线小于此值为排水沟
+    float stageRise;        // 每级边坡高度（挖方、填方相同）
+    float platformBand;     // 距分级高程小于此值的单元为平台
+    int stages;             // 边坡级数
+
+    static SlopeRuleSet compile(const SlopeParameters& params);
+};
+
+// 分类一行单元
+// below/above 为该行上下两排节点高程（count+1个），base 为各单元中心处设计高程，offset 为各单元中心距中线的横向距离
+// 地面高于设计高程为挖方，低于为填方，两者按高差绝对值分级
+void classifySlopeRow(const SlopeRuleSet& rules, const float* offset, const float* below, const float* above,
+                      const float* base, unsigned char* out, size_t count);
+
+// 按行并行分类整个格网：单元中心投影到平面线形得到桩号与横向距离，设计高程取自坡度线
+void classifySlopeGrid(const SlopeRuleSet& rules, const HorizontalAlignment& alignment,
+                       const VerticalAlignment& gradeline, SlopeGrid& grid, int threadCount = 0);
+
+// 当前编译使用的指令集（"AVX2"、"SSE"或"scalar"）
+const char* slopeKernelPath();
\ No newline at end of file
@@ -0,0 +1,336 @@
+#include "Terrain.h"
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+// DEM瓦片文件格式：64字节小端文件头 + 按瓦片行优先排列的float32高程（边缘瓦片补齐）
+static const char kDemMagic[4] = { 'R', 'D', 'E', 'M' };
+static const qint32 kDemVersion = 1;
+static const qint64 kDemHeaderSize = 64;
+static const qint32 kMaxTileSize = 8192;
+
+// 小端float读写（按位复制）
+static float readFloatLE(const uchar* p) {
+    quint32 bits = qFromLittleEndian<quint32>(p);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void writeFloatLE(float value, uchar* p) {
+    quint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    qToLittleEndian<quint32>(bits, p);
+}
+
+Terrain::Terrain()
+    : columns(0), rows(0), tileSize(0), tilesX(0), tilesY(0), spacing(1.0f),
+      dataOffset(kDemHeaderSize), maxResident(0), paged(false) {
+}
+
+Terrain::~Terrain() {
+    if(demFile) {
+        for(auto& tile : tiles) {
+            if(tile.mapped) demFile->unmap(tile.mapped);
+        }
+    }
+}
+
+// 由高程函数生成常驻内存的地形
+Terrain* Terrain::createProcedural(int columns, int rows, const osg::Vec3& origin, float spacing,
+                                   const HeightFunction& height, int tileSize) {
+    Terrain* terrain = new Terrain();
+    terrain->columns = columns;
+    terrain->rows = rows;
+    terrain->tileSize = tileSize;
+    terrain->tilesX = (columns + tileSize - 1) / tileSize;
+    terrain->tilesY = (rows + tileSize - 1) / tileSize;
+    terrain->origin = origin;
+    terrain->spacing = spacing;
+    terrain->tiles.resize(terrain->tilesX * terrain->tilesY);
+
+    for(int ty=0; ty<terrain->tilesY; ++ty) {
+        for(int tx=0; tx<terrain->tilesX; ++tx) {
+            Tile& tile = terrain->tiles[ty * terrain->tilesX + tx];
+            tile.owned.resize(tileSize * tileSize);
+            tile.data = tile.owned.data();
+            for(int j=0; j<tileSize; ++j) {
+                for(int i=0; i<tileSize; ++i) {
+                    int x = std::min(tx * tileSize + i, columns - 1);
+                    int y = std::min(ty * tileSize + j, rows - 1);
+                    tile.data[j * tileSize + i] = height(x, y);
+                }
+            }
+        }
+    }
+    return terrain;
+}
+
+// 打开瓦片DEM文件，瓦片在首次访问时才映射
+Terrain* Terrain::openDem(const QString& path, size_t maxResidentTiles) {
+    std::unique_ptr<QFile> file(new QFile(path));
+    if(!file->open(QIODevice::ReadOnly)) return nullptr;
+
+    uchar header[kDemHeaderSize];
+    if(file->read(reinterpret_cast<char*>(header), kDemHeaderSize) != kDemHeaderSize ||
+       memcmp(header, kDemMagic, 4) != 0 || qFromLittleEndian<qint32>(header + 4) != kDemVersion) {
+        return nullptr;
+    }
+
+    // 先校验文件头，通过后才分配瓦片表
+    const qint32 columns = qFromLittleEndian<qint32>(header + 8);
+    const qint32 rows = qFromLittleEndian<qint32>(header + 12);
+    const qint32 tileSize = qFromLittleEndian<qint32>(header + 16);
+    const float spacing = readFloatLE(header + 20);
+    if(columns <= 0 || rows <= 0 || tileSize <= 0 || tileSize > kMaxTileSize || !(spacing > 0)) {
+        return nullptr;
+    }
+    const qint64 tilesX = (static_cast<qint64>(columns) + tileSize - 1) / tileSize;
+    const qint64 tilesY = (static_cast<qint64>(rows) + tileSize - 1) / tileSize;
+    const qint64 expected = kDemHeaderSize + tilesX * tilesY * tileSize * tileSize * static_cast<qint64>(sizeof(float));
+    if(file->size() < expected) return nullptr;
+
+    osg::ref_ptr<Terrain> terrain = new Terrain();
+    terrain->columns = columns;
+    terrain->rows = rows;
+    terrain->tileSize = tileSize;
+    terrain->spacing = spacing;
+    terrain->origin.set(readFloatLE(header + 24),
+                        readFloatLE(header + 28),
+                        readFloatLE(header + 32));
+    terrain->tilesX = static_cast<int>(tilesX);
+    terrain->tilesY = static_cast<int>(tilesY);
+    terrain->tiles.resize(static_cast<size_t>(tilesX * tilesY));
+    terrain->maxResident = std::max<size_t>(1, maxResidentTiles);
+    terrain->paged = true;
+    terrain->demFile = std::move(file);
+    return terrain.release();
+}
+
+// 在共享地形上创建写时复制覆盖层
+Terrain* Terrain::createOverlay(const Terrain* base) {
+    Terrain* terrain = new Terrain();
+    terrain->columns = base->columns;
+    terrain->rows = base->rows;
+    terrain->tileSize = base->tileSize;
+    terrain->tilesX = base->tilesX;
+    terrain->tilesY = base->tilesY;
+    terrain->origin = base->origin;
+    terrain->spacing = base->spacing;
+    terrain->tiles.resize(base->tiles.size());
+    terrain->base = base;
+    return terrain;
+}
+
+// 导出为瓦片DEM文件
+bool Terrain::saveDem(const QString& path) const {
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly)) return false;
+
+    uchar header[kDemHeaderSize] = {};
+    memcpy(header, kDemMagic, 4);
+    qToLittleEndian<qint32>(kDemVersion, header + 4);
+    qToLittleEndian<qint32>(columns, header + 8);
+    qToLittleEndian<qint32>(rows, header + 12);
+    qToLittleEndian<qint32>(tileSize, header + 16);
+    writeFloatLE(spacing, header + 20);
+    writeFloatLE(origin.x(), header + 24);
+    writeFloatLE(origin.y(), header + 28);
+    writeFloatLE(origin.z(), header + 32);
+    if(file.write(reinterpret_cast<const char*>(header), kDemHeaderSize) != kDemHeaderSize) return false;
+
+    // 逐瓦片写出，边缘补齐
+    std::vector<float> buffer(tileSize * tileSize);
+    for(int ty=0; ty<tilesY; ++ty) {
+        for(int tx=0; tx<tilesX; ++tx) {
+            for(int j=0; j<tileSize; ++j) {
+                for(int i=0; i<tileSize; ++i) {
+                    buffer[j * tileSize + i] = getHeight(tx * tileSize + i, ty * tileSize + j);
+                }
+            }
+            qint64 bytes = static_cast<qint64>(buffer.size() * sizeof(float));
+            if(file.write(reinterpret_cast<const char*>(buffer.data()), bytes) != bytes) return false;
+        }
+    }
+    return true;
+}
+
+// 网格点所在瓦片编号与瓦片内偏移（越界坐标夹取到边缘）
+int Terrain::tileIndex(int x, int y, int& offset) const {
+    x = osg::clampBetween(x, 0, columns - 1);
+    y = osg::clampBetween(y, 0, rows - 1);
+    offset = (y % tileSize) * tileSize + x % tileSize;
+    return (y / tileSize) * tilesX + x / tileSize;
+}
+
+// 定位网格点所在瓦片，必要时调入（分页模式下调用方须持有tileMutex）
+float* Terrain::tileData(int x, int y, int& offset) const {
+    int index = tileIndex(x, y, offset);
+    Tile& tile = tiles[index];
+    if(paged && !tile.modified) {
+        if(tile.data) {
+            lruOrder.splice(lruOrder.begin(), lruOrder, tile.lru);
+        } else {
+            loadTile(index);
+        }
+    }
+    return tile.data;
+}
+
+// 覆盖层取得可写的私有瓦片，首次写入时从底层复制（调用方须持有tileMutex）
+float* Terrain::overlayTile(int index) {
+    Tile& tile = tiles[index];
+    if(tile.data) return tile.data;
+
+    const int tx = index % tilesX;
+    const int ty = index / tilesX;
+    tile.owned.resize(tileSize * tileSize);
+    std::vector<int> xs(tileSize), ys(tileSize);
+    for(int i=0; i<tileSize; ++i) {
+        xs[i] = std::min(tx * tileSize + i, columns - 1);
+    }
+    for(int j=0; j<tileSize; ++j) {
+        std::fill(ys.begin(), ys.end(), std::min(ty * tileSize + j, rows - 1));
+        base->gatherHeights(xs.data(), ys.data(), &tile.owned[j * tileSize], tileSize);
+    }
+    tile.data = tile.owned.data();
+    tile.modified = true;
+    return tile.data;
+}
+
+// 写时复制映射单个瓦片
+void Terrain::loadTile(int index) const {
+    Tile& tile = tiles[index];
+    qint64 bytes = static_cast<qint64>(tileSize) * tileSize * sizeof(float);
+    tile.mapped = demFile->map(dataOffset + index * bytes, bytes, QFileDevice::MapPrivateOption);
+    if(!tile.mapped) {
+        // 映射失败时退化为读入内存
+        tile.owned.assign(tileSize * tileSize, 0.0f);
+        demFile->seek(dataOffset + index * bytes);
+        demFile->read(reinterpret_cast<char*>(tile.owned.data()), bytes);
+        tile.data = tile.owned.data();
+    } else {
+        tile.data = reinterpret_cast<float*>(tile.mapped);
+    }
+    lruOrder.push_front(index);
+    tile.lru = lruOrder.begin();
+    evictTiles();
+}
+
+// 超出常驻上限时淘汰最久未用的瓦片
+void Terrain::evictTiles() const {
+    while(lruOrder.size() > maxResident) {
+        Tile& tile = tiles[lruOrder.back()];
+        lruOrder.pop_back();
+        if(tile.mapped) demFile->unmap(tile.mapped);
+        tile.mapped = nullptr;
+        tile.data = nullptr;
+        std::vector<float>().swap(tile.owned);
+    }
+}
+
+float Terrain::getHeight(int x, int y) const {
+    int offset;
+    if(!paged && !base) return tileData(x, y, offset)[offset];
+
+    std::lock_guard<std::mutex> lock(tileMutex);
+    if(base) {
+        // 覆盖层：未复制的瓦片直接读取底层
+        const Tile& tile = tiles[tileIndex(x, y, offset)];
+        return tile.data ? tile.data[offset] : base->getHeight(x, y);
+    }
+    return tileData(x, y, offset)[offset];
+}
+
+// 批量读取网格高程，分页模式下整批只加锁一次
+void Terrain::gatherHeights(const int* xs, const int* ys, float* out, size_t count) const {
+    std::unique_lock<std::mutex> lock(tileMutex, std::defer_lock);
+    if(paged || base) lock.lock();
+    
+    int offset;
+    if(!base) {
+        for(size_t i=0; i<count; ++i) {
+            out[i] = tileData(xs[i], ys[i], offset)[offset];
+        }
+        return;
+    }
+    
+    // 覆盖层：私有瓦片就地读取，其余格点汇总后向底层批量查询
+    std::vector<int> pending, pendingX, pendingY;
+    for(size_t i=0; i<count; ++i) {
+        const Tile& tile = tiles[tileIndex(xs[i], ys[i], offset)];
+        if(tile.data) {
+            out[i] = tile.data[offset];
+        } else {
+            pending.push_back(static_cast<int>(i));
+            pendingX.push_back(xs[i]);
+            pendingY.push_back(ys[i]);
+        }
+    }
+    if(pending.empty()) return;
+    std::vector<float> heights(pending.size());
+    base->gatherHeights(pendingX.data(), pendingY.data(), heights.data(), pending.size());
+    for(size_t k=0; k<pending.size(); ++k) {
+        out[pending[k]] = heights[k];
+    }
+}
+
+void Terrain::setHeight(int x, int y, float z) {
+    int offset;
+    if(!paged && !base) {
+        tileData(x, y, offset)[offset] = z;
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(tileMutex);
+    if(base) {
+        int index = tileIndex(x, y, offset);
+        overlayTile(index)[offset] = z;
+        return;
+    }
+
+    // 修改过的瓦片移出淘汰队列，避免丢失写入
+    float* data = tileData(x, y, offset);
+    Tile& tile = tiles[tileIndex(x, y, offset)];
+    if(!tile.modified) {
+        lruOrder.erase(tile.lru);
+        tile.modified = true;
+    }
+    data[offset] = z;
+}
+
+// 批量写入网格高程，分页或覆盖层模式下整批只加锁一次
+void Terrain::scatterHeights(const int* xs, const int* ys, const float* values, size_t count) {
+    std::unique_lock<std::mutex> lock(tileMutex, std::defer_lock);
+    if(paged || base) lock.lock();
+    
+    int offset;
+    for(size_t i=0; i<count; ++i) {
+        if(base) {
+            int index = tileIndex(xs[i], ys[i], offset);
+            overlayTile(index)[offset] = values[i];
+            continue;
+        }
+        float* data = tileData(xs[i], ys[i], offset);
+        if(paged) {
+            // 修改过的瓦片移出淘汰队列，避免丢失写入
+            Tile& tile = tiles[tileIndex(xs[i], ys[i], offset)];
+            if(!tile.modified) {
+                lruOrder.erase(tile.lru);
+                tile.modified = true;
+            }
+        }
+        data[offset] = values[i];
+    }
+}
+
+// 网格点对应的世界坐标
+osg::Vec3 Terrain::getVertex(int x, int y) const {
+    return osg::Vec3(origin.x() + x * spacing, origin.y() + y * spacing, getHeight(x, y));
+}
+
+size_t Terrain::getResidentTileCount() const {
+    if(!paged && !base) return tiles.size();
+    std::lock_guard<std::mutex> lock(tileMutex);
+    return std::count_if(tiles.begin(), tiles.end(), [](const Tile& tile) { return tile.data != nullptr; });
+}
\ No newline at end of file
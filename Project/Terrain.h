@@ -0,0 +1,78 @@
+#pragma once
+#include <osg/Referenced>
+#include <osg/Vec3>
+#include <QFile>
+#include <QString>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// 地形高程服务（桥梁、隧道、边坡建模共用）
+// 高程按方形瓦片存放：程序生成的地形常驻内存，DEM文件按瓦片懒加载内存映射，
+// 常驻瓦片数超过上限时按最近最少使用顺序解除映射；被修改过的瓦片常驻不淘汰
+// 需要修改地形的建模引擎通过写时复制覆盖层访问共享地形：读取直通底层，
+// 首次写入某瓦片时复制为私有瓦片，修改对底层及其他引擎不可见
+class Terrain : public osg::Referenced {
+public:
+    typedef std::function<float(int, int)> HeightFunction;
+
+    static Terrain* createProcedural(int columns, int rows, const osg::Vec3& origin, float spacing,
+                                     const HeightFunction& height, int tileSize = 256);
+    static Terrain* openDem(const QString& path, size_t maxResidentTiles = 256);
+    static Terrain* createOverlay(const Terrain* base);
+    bool saveDem(const QString& path) const;
+
+    int getNumColumns() const { return columns; }
+    int getNumRows() const { return rows; }
+    int getTileSize() const { return tileSize; }
+    const osg::Vec3& getOrigin() const { return origin; }
+    float getSpacing() const { return spacing; }
+
+    float getHeight(int x, int y) const;
+    void gatherHeights(const int* xs, const int* ys, float* out, size_t count) const;
+    void setHeight(int x, int y, float z);
+    void scatterHeights(const int* xs, const int* ys, const float* values, size_t count);
+    osg::Vec3 getVertex(int x, int y) const;
+    size_t getResidentTileCount() const;
+
+protected:
+    Terrain();
+    ~Terrain();
+
+private:
+    // 单个瓦片：owned为内存瓦片，mapped为文件映射（写时复制）
+    struct Tile {
+        float* data;
+        uchar* mapped;
+        std::vector<float> owned;
+        bool modified;
+        std::list<int>::iterator lru;
+        Tile() : data(nullptr), mapped(nullptr), modified(false) {}
+    };
+
+    int tileIndex(int x, int y, int& offset) const;
+    float* tileData(int x, int y, int& offset) const;
+    float* overlayTile(int index);
+    void loadTile(int index) const;
+    void evictTiles() const;
+
+    int columns;
+    int rows;
+    int tileSize;
+    int tilesX;
+    int tilesY;
+    osg::Vec3 origin;
+    float spacing;
+
+    // 瓦片缓存（const查询也会调入瓦片）
+    mutable std::vector<Tile> tiles;
+    mutable std::list<int> lruOrder;
+    mutable std::mutex tileMutex;
+    mutable std::unique_ptr<QFile> demFile;
+    qint64 dataOffset;
+    size_t maxResident;
+    bool paged;
+    osg::ref_ptr<const Terrain> base;   // 覆盖层的底层地形（非覆盖层为空）
+};
\ No newline at end of file
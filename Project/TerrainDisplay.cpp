@@ -0,0 +1,112 @@
+#include "TerrainDisplay.h"
+#include <cfloat>
+#include <cmath>
+
+// 清空显示块
+void TerrainDisplay::clear() {
+    geode->removeDrawables(0, geode->getNumDrawables());
+    blocks.clear();
+}
+
+// 显示世界坐标窗口内的地形
+void TerrainDisplay::showWindow(const Terrain* source, const osg::BoundingBox& window) {
+    clear();
+    terrain = source;
+    if(terrain && window.valid()) addWindow(window, nullptr, 0);
+}
+
+// 显示线路两侧margin范围内的地形：取线路包围盒，只保留与中线距离不超过margin的块
+void TerrainDisplay::showCorridor(const Terrain* source, const HorizontalAlignment& alignment, float margin) {
+    clear();
+    terrain = source;
+    if(!terrain || !alignment.isValid()) return;
+    
+    osg::BoundingBox window;
+    for(const auto& p : alignment.vertices()) {
+        window.expandBy(p);
+    }
+    window.xMin() -= margin;
+    window.yMin() -= margin;
+    window.xMax() += margin;
+    window.yMax() += margin;
+    addWindow(window, &alignment, margin);
+}
+
+// 窗口按瓦片边界切分为显示块；给定线路时剔除离中线过远的块
+void TerrainDisplay::addWindow(const osg::BoundingBox& window, const HorizontalAlignment* alignment, float margin) {
+    const osg::Vec3& origin = terrain->getOrigin();
+    const float spacing = terrain->getSpacing();
+    const int tileSize = terrain->getTileSize();
+    int x0 = std::max(0, static_cast<int>(floorf((window.xMin() - origin.x()) / spacing)));
+    int y0 = std::max(0, static_cast<int>(floorf((window.yMin() - origin.y()) / spacing)));
+    int x1 = std::min(terrain->getNumColumns() - 1, static_cast<int>(ceilf((window.xMax() - origin.x()) / spacing)));
+    int y1 = std::min(terrain->getNumRows() - 1, static_cast<int>(ceilf((window.yMax() - origin.y()) / spacing)));
+    if(x0 > x1 || y0 > y1) return;
+    
+    for(int ty=y0/tileSize; ty<=y1/tileSize; ++ty) {
+        for(int tx=x0/tileSize; tx<=x1/tileSize; ++tx) {
+            int bx0 = std::max(x0, tx * tileSize), bx1 = std::min(x1, (tx + 1) * tileSize - 1);
+            int by0 = std::max(y0, ty * tileSize), by1 = std::min(y1, (ty + 1) * tileSize - 1);
+            if(alignment) {
+                // 块中心到中线折线的平面距离，扣除半对角线后仍超出margin的块不显示
+                const std::vector<osg::Vec3>& points = alignment->vertices();
+                osg::Vec2 centre(origin.x() + 0.5f * (bx0 + bx1) * spacing, origin.y() + 0.5f * (by0 + by1) * spacing);
+                float halfDiagonal = 0.5f * spacing * sqrtf(float((bx1 - bx0) * (bx1 - bx0) + (by1 - by0) * (by1 - by0)));
+                float distance = FLT_MAX;
+                for(size_t i=0; i+1<points.size(); ++i) {
+                    osg::Vec2 a(points[i].x(), points[i].y());
+                    osg::Vec2 d = osg::Vec2(points[i+1].x(), points[i+1].y()) - a;
+                    float len2 = d.length2();
+                    float t = len2 > 0 ? osg::clampBetween(((centre - a) * d) / len2, 0.0f, 1.0f) : 0.0f;
+                    distance = std::min(distance, (centre - (a + d * t)).length());
+                }
+                if(distance - halfDiagonal > margin) continue;
+            }
+            addBlock(bx0, by0, bx1, by1);
+        }
+    }
+}
+
+// 创建显示块并读入高程
+void TerrainDisplay::addBlock(int x0, int y0, int x1, int y1) {
+    Block block = { x0, y0, x1, y1, new osg::Vec3Array((x1 - x0 + 1) * (y1 - y0 + 1)), new osg::Geometry() };
+    readRows(block, x0, y0, x1, y1);
+    block.geometry->setVertexArray(block.vertices);
+    block.geometry->addPrimitiveSet(new osg::DrawArrays(GL_POINTS, 0, block.vertices->size()));
+    geode->addDrawable(block.geometry);
+    blocks.push_back(block);
+}
+
+// 按行批量读取子区间[x0,x1]x[y0,y1]的高程写入显示块顶点，每行只访问一次地形
+void TerrainDisplay::readRows(Block& block, int x0, int y0, int x1, int y1) {
+    const osg::Vec3& origin = terrain->getOrigin();
+    const float spacing = terrain->getSpacing();
+    const int stride = block.x1 - block.x0 + 1;
+    const int width = x1 - x0 + 1;
+    std::vector<int> xs(width), ys(width);
+    std::vector<float> heights(width);
+    for(int i=0; i<width; ++i) {
+        xs[i] = x0 + i;
+    }
+    for(int y=y0; y<=y1; ++y) {
+        std::fill(ys.begin(), ys.end(), y);
+        terrain->gatherHeights(xs.data(), ys.data(), heights.data(), width);
+        osg::Vec3* row = &(*block.vertices)[(y - block.y0) * stride + (x0 - block.x0)];
+        for(int i=0; i<width; ++i) {
+            row[i].set(origin.x() + xs[i] * spacing, origin.y() + y * spacing, heights[i]);
+        }
+    }
+}
+
+// 只重新读取脏区域覆盖的顶点，只提交与脏区域相交的显示块
+void TerrainDisplay::refresh(const TerrainDirtyRegion& region) {
+    if(!region.valid()) return;
+    for(auto& block : blocks) {
+        int x0 = std::max(block.x0, region.xMin), x1 = std::min(block.x1, region.xMax);
+        int y0 = std::max(block.y0, region.yMin), y1 = std::min(block.y1, region.yMax);
+        if(x0 > x1 || y0 > y1) continue;
+        readRows(block, x0, y0, x1, y1);
+        block.vertices->dirty();
+        block.geometry->dirtyBound();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include <osg/Geode>
+#include <osg/Geometry>
+#include "Terrain.h"
+#include "Alignment.h"
+#include <algorithm>
+#include <vector>
+#include <climits>
+
+// 地形脏区域（格网索引闭区间）
+struct TerrainDirtyRegion {
+    int xMin, yMin, xMax, yMax;
+    
+    TerrainDirtyRegion() { reset(); }
+    void reset() { xMin = yMin = INT_MAX; xMax = yMax = INT_MIN; }
+    bool valid() const { return xMin <= xMax && yMin <= yMax; }
+    void expandBy(int x0, int y0, int x1, int y1) {
+        xMin = std::min(xMin, x0);
+        yMin = std::min(yMin, y0);
+        xMax = std::max(xMax, x1);
+        yMax = std::max(yMax, y1);
+    }
+};
+
+// 地形显示网格：只覆盖线路附近的窗口，按地形瓦片分块，每块一个独立的点集几何体
+// 高程按行批量读取，不复制整幅DEM
+class TerrainDisplay {
+public:
+    TerrainDisplay() : geode(new osg::Geode()) {}
+    osg::Geode* getGeode() const { return geode.get(); }
+
+    void clear();
+    void showWindow(const Terrain* terrain, const osg::BoundingBox& window);
+    void showCorridor(const Terrain* terrain, const HorizontalAlignment& alignment, float margin);
+    void refresh(const TerrainDirtyRegion& region);
+
+private:
+    // 显示块：格网闭区间[x0,x1]x[y0,y1]，顶点按行优先排列
+    struct Block {
+        int x0, y0, x1, y1;
+        osg::ref_ptr<osg::Vec3Array> vertices;
+        osg::ref_ptr<osg::Geometry> geometry;
+    };
+
+    void addWindow(const osg::BoundingBox& window, const HorizontalAlignment* alignment, float margin);
+    void addBlock(int x0, int y0, int x1, int y1);
+    void readRows(Block& block, int x0, int y0, int x1, int y1);
+
+    osg::ref_ptr<const Terrain> terrain;
+    osg::ref_ptr<osg::Geode> geode;
+    std::vector<Block> blocks;
+};
\ No newline at end of file
@@ -0,0 +1,236 @@
+#include "TerrainIntersector.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// 最细一层每块的格网单元数
+static const int kLeafBlockCells = 8;
+
+bool intersectSegmentTriangle(const osg::Vec3& start, const osg::Vec3& dir,
+                              const osg::Vec3& v0, const osg::Vec3& v1, const osg::Vec3& v2, float& t) {
+    osg::Vec3 e1 = v1 - v0;
+    osg::Vec3 e2 = v2 - v0;
+    osg::Vec3 p = dir ^ e2;
+    float det = e1 * p;
+    // 平行判定的容差随边长与线段长度缩放，使判定与坐标尺度无关
+    const float eps = 1e-6f * e1.length() * e2.length() * dir.length();
+    if(fabs(det) <= eps) return false;   // 线段与三角形平行
+
+    // 重心坐标允许微小负值，避免交点恰好落在公共边上时漏检
+    const float edgeEps = 1e-6f;
+    float inv = 1.0f / det;
+    osg::Vec3 s = start - v0;
+    float u = (s * p) * inv;
+    if(u < -edgeEps || u > 1 + edgeEps) return false;
+    osg::Vec3 q = s ^ e1;
+    float v = (dir * q) * inv;
+    if(v < -edgeEps || u + v > 1 + edgeEps) return false;
+    t = (e2 * q) * inv;
+    return t >= 0 && t <= 1;
+}
+
+TerrainIntersector::TerrainIntersector(const Terrain* t) : terrain(t) {
+    cellsX = std::max(terrain->getNumColumns() - 1, 0);
+    cellsY = std::max(terrain->getNumRows() - 1, 0);
+    if(cellsX == 0 || cellsY == 0) return;
+
+    // 最细一层：逐行读取高程，单元四角的范围并入所在块
+    Level leaf;
+    leaf.cellsPerBlock = kLeafBlockCells;
+    leaf.blocksX = (cellsX + kLeafBlockCells - 1) / kLeafBlockCells;
+    leaf.blocksY = (cellsY + kLeafBlockCells - 1) / kLeafBlockCells;
+    leaf.zMin.assign(leaf.blocksX * leaf.blocksY, FLT_MAX);
+    leaf.zMax.assign(leaf.blocksX * leaf.blocksY, -FLT_MAX);
+
+    const int columns = terrain->getNumColumns();
+    std::vector<int> xs(columns), ys(columns);
+    std::vector<float> below(columns), above(columns);
+    for(int x=0; x<columns; ++x) xs[x] = x;
+    std::fill(ys.begin(), ys.end(), 0);
+    terrain->gatherHeights(xs.data(), ys.data(), below.data(), columns);
+    for(int cy=0; cy<cellsY; ++cy) {
+        std::fill(ys.begin(), ys.end(), cy + 1);
+        terrain->gatherHeights(xs.data(), ys.data(), above.data(), columns);
+        float* zMin = &leaf.zMin[(cy / kLeafBlockCells) * leaf.blocksX];
+        float* zMax = &leaf.zMax[(cy / kLeafBlockCells) * leaf.blocksX];
+        for(int cx=0; cx<cellsX; ++cx) {
+            float lo = std::min(std::min(below[cx], below[cx+1]), std::min(above[cx], above[cx+1]));
+            float hi = std::max(std::max(below[cx], below[cx+1]), std::max(above[cx], above[cx+1]));
+            int b = cx / kLeafBlockCells;
+            zMin[b] = std::min(zMin[b], lo);
+            zMax[b] = std::max(zMax[b], hi);
+        }
+        below.swap(above);
+    }
+    levels.push_back(leaf);
+
+    // 逐层2x2合并，直到只剩一块
+    while(levels.back().blocksX > 1 || levels.back().blocksY > 1) {
+        const Level& child = levels.back();
+        Level parent;
+        parent.cellsPerBlock = child.cellsPerBlock * 2;
+        parent.blocksX = (child.blocksX + 1) / 2;
+        parent.blocksY = (child.blocksY + 1) / 2;
+        parent.zMin.assign(parent.blocksX * parent.blocksY, FLT_MAX);
+        parent.zMax.assign(parent.blocksX * parent.blocksY, -FLT_MAX);
+        for(int by=0; by<child.blocksY; ++by) {
+            for(int bx=0; bx<child.blocksX; ++bx) {
+                int p = (by / 2) * parent.blocksX + bx / 2;
+                int c = by * child.blocksX + bx;
+                parent.zMin[p] = std::min(parent.zMin[p], child.zMin[c]);
+                parent.zMax[p] = std::max(parent.zMax[p], child.zMax[c]);
+            }
+        }
+        levels.push_back(parent);
+    }
+}
+
+// 最近交点
+bool TerrainIntersector::intersect(const osg::Vec3& start, const osg::Vec3& end, TerrainHit& hit) const {
+    if(levels.empty()) return false;
+    Query query;
+    query.start = start;
+    query.dir = end - start;
+    query.nearestOnly = true;
+    query.hits = nullptr;
+    query.best.ratio = FLT_MAX;
+    query.found = false;
+    visitBlock(query, static_cast<int>(levels.size()) - 1, 0, 0);
+    if(query.found) hit = query.best;
+    return query.found;
+}
+
+// 全部交点（按线段参数排序，公共边上的重复交点只保留一个）
+size_t TerrainIntersector::intersectAll(const osg::Vec3& start, const osg::Vec3& end, std::vector<TerrainHit>& hits) const {
+    if(levels.empty()) return 0;
+    std::vector<TerrainHit> found;
+    Query query;
+    query.start = start;
+    query.dir = end - start;
+    query.nearestOnly = false;
+    query.hits = &found;
+    query.found = false;
+    visitBlock(query, static_cast<int>(levels.size()) - 1, 0, 0);
+
+    // 重复交点按世界坐标距离判定（千分之一格距），与线段长短无关
+    std::sort(found.begin(), found.end(), [](const TerrainHit& a, const TerrainHit& b) { return a.ratio < b.ratio; });
+    const float tolerance = 1e-3f * terrain->getSpacing();
+    size_t added = 0;
+    for(const auto& h : found) {
+        if(added > 0 && (h.point - hits.back().point).length2() < tolerance * tolerance) continue;
+        hits.push_back(h);
+        ++added;
+    }
+    return added;
+}
+
+// 线段与轴对齐包围盒求交（平面方向用平板法裁剪，再比较裁剪区间内的线段高程范围）
+bool TerrainIntersector::clipBox(const Query& query, float x0, float y0, float x1, float y1,
+                                 float zMin, float zMax, float& tMin) const {
+    const float eps = 1e-4f;
+    float t0 = 0.0f, t1 = 1.0f;
+    const float lo[2] = { x0 - eps, y0 - eps };
+    const float hi[2] = { x1 + eps, y1 + eps };
+    for(int axis=0; axis<2; ++axis) {
+        float o = query.start[axis];
+        float d = query.dir[axis];
+        if(fabs(d) < 1e-12f) {
+            if(o < lo[axis] || o > hi[axis]) return false;
+            continue;
+        }
+        float ta = (lo[axis] - o) / d;
+        float tb = (hi[axis] - o) / d;
+        if(ta > tb) std::swap(ta, tb);
+        t0 = std::max(t0, ta);
+        t1 = std::min(t1, tb);
+        if(t0 > t1) return false;
+    }
+    float za = query.start.z() + query.dir.z() * t0;
+    float zb = query.start.z() + query.dir.z() * t1;
+    if(std::max(za, zb) < zMin - eps || std::min(za, zb) > zMax + eps) return false;
+    tMin = t0;
+    return true;
+}
+
+// 层次遍历：先按进入参数排序子块，求最近交点时跳过比当前结果更远的块
+void TerrainIntersector::visitBlock(Query& query, int level, int bx, int by) const {
+    const Level& l = levels[level];
+    const osg::Vec3& origin = terrain->getOrigin();
+    const float spacing = terrain->getSpacing();
+
+    // 顶层从唯一的根块开始；其余层展开上一层块的2x2子块
+    struct Candidate { int bx, by; float t; };
+    Candidate candidates[4];
+    int count = 0;
+    const int range = level + 1 < static_cast<int>(levels.size()) ? 2 : 1;
+    for(int j=0; j<range; ++j) {
+        for(int i=0; i<range; ++i) {
+            int cx = bx * range + i;
+            int cy = by * range + j;
+            if(cx >= l.blocksX || cy >= l.blocksY) continue;
+            int k = cy * l.blocksX + cx;
+            float x0 = origin.x() + cx * l.cellsPerBlock * spacing;
+            float y0 = origin.y() + cy * l.cellsPerBlock * spacing;
+            float x1 = origin.x() + std::min((cx + 1) * l.cellsPerBlock, cellsX) * spacing;
+            float y1 = origin.y() + std::min((cy + 1) * l.cellsPerBlock, cellsY) * spacing;
+            float t;
+            if(clipBox(query, x0, y0, x1, y1, l.zMin[k], l.zMax[k], t)) {
+                candidates[count++] = { cx, cy, t };
+            }
+        }
+    }
+    std::sort(candidates, candidates + count, [](const Candidate& a, const Candidate& b) { return a.t < b.t; });
+
+    for(int c=0; c<count; ++c) {
+        if(query.nearestOnly && query.found && candidates[c].t > query.best.ratio) break;
+        if(level > 0) {
+            visitBlock(query, level - 1, candidates[c].bx, candidates[c].by);
+            continue;
+        }
+        // 最细一层：逐个测试块内与线段相交的单元
+        int cx0 = candidates[c].bx * l.cellsPerBlock;
+        int cy0 = candidates[c].by * l.cellsPerBlock;
+        int cx1 = std::min(cx0 + l.cellsPerBlock, cellsX);
+        int cy1 = std::min(cy0 + l.cellsPerBlock, cellsY);
+        for(int cy=cy0; cy<cy1; ++cy) {
+            for(int cx=cx0; cx<cx1; ++cx) {
+                float t;
+                if(clipBox(query, origin.x() + cx * spacing, origin.y() + cy * spacing,
+                           origin.x() + (cx + 1) * spacing, origin.y() + (cy + 1) * spacing, -FLT_MAX, FLT_MAX, t)) {
+                    testCell(query, cx, cy);
+                }
+            }
+        }
+    }
+}
+
+// 单元两三角形求交
+void TerrainIntersector::testCell(Query& query, int cx, int cy) const {
+    const int xs[4] = { cx, cx + 1, cx, cx + 1 };
+    const int ys[4] = { cy, cy, cy + 1, cy + 1 };
+    float z[4];
+    terrain->gatherHeights(xs, ys, z, 4);
+
+    const osg::Vec3& origin = terrain->getOrigin();
+    const float spacing = terrain->getSpacing();
+    osg::Vec3 v[4];
+    for(int i=0; i<4; ++i) {
+        v[i] = origin + osg::Vec3(xs[i] * spacing, ys[i] * spacing, z[i]);
+    }
+
+    // 沿 (cx, cy)-(cx+1, cy+1) 对角线剖分
+    const int triangles[2][3] = { { 0, 1, 3 }, { 0, 3, 2 } };
+    for(const auto& tri : triangles) {
+        float t;
+        if(!intersectSegmentTriangle(query.start, query.dir, v[tri[0]], v[tri[1]], v[tri[2]], t)) continue;
+        TerrainHit hit = { query.start + query.dir * t, t, cx, cy };
+        if(query.nearestOnly) {
+            if(t < query.best.ratio) {
+                query.best = hit;
+                query.found = true;
+            }
+        } else {
+            query.hits->push_back(hit);
+        }
+    }
+}
\ No newline at end of file
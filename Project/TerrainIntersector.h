@@ -0,0 +1,52 @@
+#pragma once
+#include "Terrain.h"
+#include <osg/Vec3>
+#include <vector>
+
+// 线段与地形的交点
+struct TerrainHit {
+    osg::Vec3 point;    // 交点世界坐标
+    float ratio;        // 交点在线段上的参数（0为起点，1为终点）
+    int cellX, cellY;   // 所在格网单元
+};
+
+// 地形求交索引：每个格网单元按对角线剖分为两个三角形，
+// 在单元之上建立最小/最大高程层次包围体（四叉树金字塔），
+// 查询时只下降到与线段包围区间相交的块，再对块内单元做线段-三角形求交
+class TerrainIntersector {
+public:
+    explicit TerrainIntersector(const Terrain* terrain);
+
+    bool intersect(const osg::Vec3& start, const osg::Vec3& end, TerrainHit& hit) const;
+    size_t intersectAll(const osg::Vec3& start, const osg::Vec3& end, std::vector<TerrainHit>& hits) const;
+
+private:
+    // 金字塔的一层：按块存放高程范围
+    struct Level {
+        int blocksX, blocksY;
+        int cellsPerBlock;              // 每块边长（格网单元数）
+        std::vector<float> zMin, zMax;
+    };
+
+    // 线段查询状态
+    struct Query {
+        osg::Vec3 start, dir;
+        bool nearestOnly;
+        std::vector<TerrainHit>* hits;
+        TerrainHit best;
+        bool found;
+    };
+
+    bool clipBox(const Query& query, float x0, float y0, float x1, float y1,
+                 float zMin, float zMax, float& tMin) const;
+    void visitBlock(Query& query, int level, int bx, int by) const;
+    void testCell(Query& query, int cx, int cy) const;
+
+    osg::ref_ptr<const Terrain> terrain;
+    int cellsX, cellsY;
+    std::vector<Level> levels;          // levels[0] 为最细一层
+};
+
+// 线段-三角形求交（Möller–Trumbore），命中时返回线段参数 t ∈ [0, 1]
+bool intersectSegmentTriangle(const osg::Vec3& start, const osg::Vec3& dir,
+                              const osg::Vec3& v0, const osg::Vec3& v1, const osg::Vec3& v2, float& t);
\ No newline at end of file
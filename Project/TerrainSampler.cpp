@@ -0,0 +1,100 @@
+#include "TerrainSampler.h"
+#include <algorithm>
+#include <cmath>
+
+// 每组查询数
+static const size_t kGroupSize = 64;
+
+TerrainSampler::TerrainSampler(const Terrain* t, TerrainInterpolation m) : terrain(t), mode(m) {
+}
+
+float TerrainSampler::sample(float x, float y) const {
+    float z;
+    sampleGroup(&x, &y, &z, 1);
+    return z;
+}
+
+void TerrainSampler::sample(const float* xs, const float* ys, float* out, size_t count) const {
+    for(size_t i=0; i<count; i+=kGroupSize) {
+        sampleGroup(xs + i, ys + i, out + i, std::min(kGroupSize, count - i));
+    }
+}
+
+// 单组插值（count <= kGroupSize）
+void TerrainSampler::sampleGroup(const float* xs, const float* ys, float* out, size_t count) const {
+    const osg::Vec3& origin = terrain->getOrigin();
+    const float invSpacing = 1.0f / terrain->getSpacing();
+    const float maxX = static_cast<float>(terrain->getNumColumns() - 1);
+    const float maxY = static_cast<float>(terrain->getNumRows() - 1);
+
+    // 世界坐标转格网坐标，拆分为整数格与小数偏移
+    int ix[kGroupSize], iy[kGroupSize];
+    float fx[kGroupSize], fy[kGroupSize];
+    for(size_t i=0; i<count; ++i) {
+        float gx = osg::clampBetween((xs[i] - origin.x()) * invSpacing, 0.0f, maxX);
+        float gy = osg::clampBetween((ys[i] - origin.y()) * invSpacing, 0.0f, maxY);
+        float cx = floorf(gx);
+        float cy = floorf(gy);
+        ix[i] = static_cast<int>(cx);
+        iy[i] = static_cast<int>(cy);
+        fx[i] = gx - cx;
+        fy[i] = gy - cy;
+    }
+
+    if(mode == INTERPOLATE_BILINEAR) {
+        // 角点按 [角点][查询] 排列，插值循环可直接向量化
+        int cxs[4 * kGroupSize], cys[4 * kGroupSize];
+        float h[4 * kGroupSize];
+        for(int k=0; k<4; ++k) {
+            for(size_t i=0; i<count; ++i) {
+                cxs[k * kGroupSize + i] = ix[i] + (k & 1);
+                cys[k * kGroupSize + i] = iy[i] + (k >> 1);
+            }
+        }
+        for(int k=0; k<4; ++k) {
+            terrain->gatherHeights(cxs + k * kGroupSize, cys + k * kGroupSize, h + k * kGroupSize, count);
+        }
+        const float* h00 = h;
+        const float* h10 = h + kGroupSize;
+        const float* h01 = h + 2 * kGroupSize;
+        const float* h11 = h + 3 * kGroupSize;
+        for(size_t i=0; i<count; ++i) {
+            float bottom = h00[i] + (h10[i] - h00[i]) * fx[i];
+            float top = h01[i] + (h11[i] - h01[i]) * fx[i];
+            out[i] = bottom + (top - bottom) * fy[i];
+        }
+        return;
+    }
+
+    // 双三次（Catmull-Rom）：4x4邻域，先求两个方向的权重
+    float wx[4][kGroupSize], wy[4][kGroupSize];
+    for(size_t i=0; i<count; ++i) {
+        float t = fx[i], t2 = t * t, t3 = t2 * t;
+        wx[0][i] = 0.5f * (-t3 + 2.0f * t2 - t);
+        wx[1][i] = 0.5f * (3.0f * t3 - 5.0f * t2 + 2.0f);
+        wx[2][i] = 0.5f * (-3.0f * t3 + 4.0f * t2 + t);
+        wx[3][i] = 0.5f * (t3 - t2);
+        float u = fy[i], u2 = u * u, u3 = u2 * u;
+        wy[0][i] = 0.5f * (-u3 + 2.0f * u2 - u);
+        wy[1][i] = 0.5f * (3.0f * u3 - 5.0f * u2 + 2.0f);
+        wy[2][i] = 0.5f * (-3.0f * u3 + 4.0f * u2 + u);
+        wy[3][i] = 0.5f * (u3 - u2);
+    }
+
+    float acc[kGroupSize] = {};
+    int cxs[kGroupSize], cys[kGroupSize];
+    float h[kGroupSize];
+    for(int r=0; r<4; ++r) {
+        for(int c=0; c<4; ++c) {
+            for(size_t i=0; i<count; ++i) {
+                cxs[i] = ix[i] + c - 1;
+                cys[i] = iy[i] + r - 1;
+            }
+            terrain->gatherHeights(cxs, cys, h, count);
+            for(size_t i=0; i<count; ++i) {
+                acc[i] += h[i] * wx[c][i] * wy[r][i];
+            }
+        }
+    }
+    std::copy(acc, acc + count, out);
+}
\ No newline at end of file
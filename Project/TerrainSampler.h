@@ -0,0 +1,25 @@
+#pragma once
+#include "Terrain.h"
+#include <cstddef>
+
+// 插值方式
+enum TerrainInterpolation {
+    INTERPOLATE_BILINEAR = 0,
+    INTERPOLATE_BICUBIC
+};
+
+// 地形高程采样器：按世界坐标(x, y)插值查询高程
+// 批量查询按固定宽度分组：先批量取格网角点高程，再对整组做无分支插值
+class TerrainSampler {
+public:
+    explicit TerrainSampler(const Terrain* terrain, TerrainInterpolation mode = INTERPOLATE_BILINEAR);
+
+    float sample(float x, float y) const;
+    void sample(const float* xs, const float* ys, float* out, size_t count) const;
+
+private:
+    void sampleGroup(const float* xs, const float* ys, float* out, size_t count) const;
+
+    osg::ref_ptr<const Terrain> terrain;
+    TerrainInterpolation mode;
+};
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "TextureCache.h"
+#include <osgDB/ReadFile>
+
+TextureCache& TextureCache::instance() {
+    static TextureCache cache;
+    return cache;
+}
+
+TextureCache::~TextureCache() {
+    waitForPreload();
+}
+
+// 材质对应的图像文件
+const char* TextureCache::imageFile(MaterialType type) {
+    switch(type) {
+        case MATERIAL_CONCRETE: return "concrete.jpg";
+        case MATERIAL_STONE: return "stone.jpg";
+        case MATERIAL_TUNNEL: return "tunnel_texture.png";
+        case MATERIAL_DITCH: return "ditch.png";
+        case MATERIAL_SLOPE: return "slope1.png";
+        default: return "default.png";
+    }
+}
+
+// 加载材质（每种材质只执行一次，并发访问者等待首次加载完成）
+TextureCache::Entry& TextureCache::load(MaterialType type) {
+    if(type < 0 || type >= MATERIAL_COUNT) type = MATERIAL_DEFAULT;
+    Entry& entry = entries[type];
+    std::call_once(entry.loaded, [&entry, type]() {
+        entry.texture = new osg::Texture2D();
+        entry.texture->setImage(osgDB::readImageFile(imageFile(type)));
+        entry.texture->setWrap(osg::Texture::WRAP_S, osg::Texture::REPEAT);
+        entry.texture->setWrap(osg::Texture::WRAP_T, osg::Texture::REPEAT);
+
+        entry.stateSet = new osg::StateSet();
+        entry.stateSet->setTextureAttributeAndModes(0, entry.texture.get(), osg::StateAttribute::ON);
+    });
+    return entry;
+}
+
+osg::Texture2D* TextureCache::getTexture(MaterialType type) {
+    return load(type).texture.get();
+}
+
+osg::StateSet* TextureCache::getStateSet(MaterialType type) {
+    return load(type).stateSet.get();
+}
+
+// 启动时在后台线程并行解码全部材质
+void TextureCache::preloadAsync() {
+    std::lock_guard<std::mutex> lock(preloadMutex);
+    for(int type=0; type<MATERIAL_COUNT; ++type) {
+        preloads.push_back(std::async(std::launch::async, [this, type]() {
+            load(static_cast<MaterialType>(type));
+        }));
+    }
+}
+
+// 等待后台预加载结束
+void TextureCache::waitForPreload() {
+    std::lock_guard<std::mutex> lock(preloadMutex);
+    for(auto& preload : preloads) {
+        preload.wait();
+    }
+    preloads.clear();
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include <osg/StateSet>
+#include <osg/Texture2D>
+#include <future>
+#include <mutex>
+#include <vector>
+
+// 材质类型
+enum MaterialType {
+    MATERIAL_DEFAULT = 0,   // default.png
+    MATERIAL_CONCRETE,      // concrete.jpg（桥面）
+    MATERIAL_STONE,         // stone.jpg（桥墩）
+    MATERIAL_TUNNEL,        // tunnel_texture.png
+    MATERIAL_DITCH,         // ditch.png（排水沟）
+    MATERIAL_SLOPE,         // slope1.png（坡面）
+    MATERIAL_COUNT
+};
+
+// 进程级纹理与状态集缓存（所有建模引擎共用，线程安全）
+// 每种材质的图像只解码一次，同种材质的几何体共享同一个StateSet，
+// 共享的StateSet不应再被单个几何体修改
+class TextureCache {
+public:
+    static TextureCache& instance();
+    static const char* imageFile(MaterialType type);
+
+    osg::Texture2D* getTexture(MaterialType type);
+    osg::StateSet* getStateSet(MaterialType type);
+
+    void preloadAsync();
+    void waitForPreload();
+
+private:
+    TextureCache() {}
+    ~TextureCache();
+    TextureCache(const TextureCache&) = delete;
+    TextureCache& operator=(const TextureCache&) = delete;
+
+    // 单个材质条目，首次访问时加载
+    struct Entry {
+        std::once_flag loaded;
+        osg::ref_ptr<osg::Texture2D> texture;
+        osg::ref_ptr<osg::StateSet> stateSet;
+    };
+    Entry& load(MaterialType type);
+
+    Entry entries[MATERIAL_COUNT];
+    std::mutex preloadMutex;
+    std::vector<std::future<void>> preloads;
+};
\ No newline at end of file
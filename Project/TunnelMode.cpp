@@ -1,11 +1,15 @@
 // TunnelModeling.cpp
-#include "TunnelModeling.h"
+#include "TunnelModel.h"
+#include "Parallel.h"
+#include "TextureCache.h"
 #include <osg/LineWidth>
-#include <osgDB/ReadFile>
-#include <QHBoxLayout>
+#include <algorithm>
+#include <cfloat>
 
 // 构造函数
-TunnelBuilder::TunnelBuilder(QWidget* parent) : QMainWindow(parent) {
+// 共享地形经覆盖层访问，挖洞只写入本引擎的私有瓦片
+TunnelBuilder::TunnelBuilder(Terrain* sharedTerrain)
+    : terrain(sharedTerrain ? Terrain::createOverlay(sharedTerrain) : nullptr) {
     // 初始化隧道参数
     params = {
         5.0f,    // entranceLength
@@ -14,137 +18,173 @@ TunnelBuilder::TunnelBuilder(QWidget* parent) : QMainWindow(parent) {
         0.5f,    // precision
         3.0f,    // heightThreshold
         10.0f,   // extensionLength
-        1        // textureType
+        1,       // textureType
+        PROFILE_CIRCLE, // profileShape
+        32,      // profileSegments
+        0.02f    // chordTolerance
     };
+    initializeScene();
+}
 
-    // 初始化Qt窗口
-    setGeometry(100, 100, 1200, 800);
-    QWidget* centralWidget = new QWidget(this);
-    QHBoxLayout* layout = new QHBoxLayout(centralWidget);
-    
-    // 初始化OSG场景
-    viewer = new osgViewer::Viewer();
+TunnelBuilder::TunnelBuilder(const TunnelParameters& parameters, Terrain* sharedTerrain)
+    : params(parameters), terrain(sharedTerrain ? Terrain::createOverlay(sharedTerrain) : nullptr) {
+    initializeScene();
+}
+
+// 初始化场景与地形
+void TunnelBuilder::initializeScene() {
     root = new osg::Group();
-    terrainGeode = new osg::Geode();
-    
-    // 加载地形数据（示例使用平面）
-    terrain.heightField = new osg::HeightField();
-    terrain.heightField->allocate(100, 100);
-    terrain.vertices = new osg::Vec3Array();
-    for(int x=0; x<100; ++x) {
-        for(int y=0; y<100; ++y) {
-            float z = 50 + 5*sin(x/10.0)*cos(y/10.0);
-            terrain.heightField->setHeight(x, y, z);
-            terrain.vertices->push_back(osg::Vec3(x, y, z));
-        }
+    root->addChild(terrainDisplay.getGeode());
+    
+    // 未提供共享地形时生成示例地形
+    if(!terrain) {
+        terrain = Terrain::createProcedural(100, 100, osg::Vec3(0, 0, 0), 1.0f, [](int x, int y) {
+            return static_cast<float>(50 + 5*sin(x/10.0)*cos(y/10.0));
+        });
     }
     
-    // 执行算法流程
+    // 默认线路沿X轴穿过地形中部，走廊宽度取洞口宽度
+    float spacing = terrain->getSpacing();
+    alignment = HorizontalAlignment::straight(
+        terrain->getOrigin() + osg::Vec3(0, terrain->getNumRows() / 2 * spacing, 0),
+        osg::Vec3(1, 0, 0), (terrain->getNumColumns() - 1) * spacing);
+    gradeline = VerticalAlignment::constant(55.0f); // 示例水平设计高程
+    profile = TunnelProfile::create(params.profileShape, params.tunnelRadius, params.profileSegments);
+    corridor = { 0.5f, params.entranceWidth, 5 };
+    detectionMode = DETECT_CORRIDOR_PROFILE;
+}
+
+// 执行算法流程
+void TunnelBuilder::run() {
+    // 地形只显示线路走廊附近的瓦片，裁剪后原地刷新
+    terrainDisplay.showCorridor(terrain.get(), alignment, 0.5f * corridor.corridorWidth + 2 * params.tunnelRadius);
     computeHighGroundAreas();
     buildTunnelGeometry();
     modifyTerrain();
-    
-    // 设置场景数据
-    viewer->setSceneData(root);
-    viewer->realize();
 }
 
 // 步骤a: 计算高地地段
 void TunnelBuilder::computeHighGroundAreas() {
-    // 遍历地形网格
-    for(int x=0; x<100; ++x) {
-        for(int y=0; y<100; ++y) {
-            float terrainZ = terrain.heightField->getHeight(x, y);
-            float planZ = 55.0f; // 示例固定规划高度
-            
-            if(terrainZ > planZ + params.heightThreshold) {
-                highGroundPoints.push_back(osg::Vec3(x, y, terrainZ));
+    tunnelSpans.clear();
+    if(detectionMode == DETECT_CORRIDOR_PROFILE) {
+        // 只采样线路走廊，整个走廊地面高出规划线阈值以上时为高地地段
+        const float D = 10.0f; // 隧道长度阈值
+        CorridorProfile profile = sampleCorridorProfile(terrain.get(), alignment, corridor);
+        std::vector<float> design(profile.size());
+        gradeline.evaluate(profile.chainage.data(), design.data(), profile.size());
+        std::vector<ProfileInterval> intervals = findProfileIntervals(profile, [&](size_t i) {
+            return profile.groundMin[i] > design[i] + params.heightThreshold;
+        });
+        TerrainSampler sampler(terrain.get());
+        for(const auto& interval : intervals) {
+            if(interval.length() > D) {
+                TunnelSpan span;
+                span.entrance = alignment.position(interval.chainageStart);
+                span.exit = alignment.position(interval.chainageEnd);
+                span.entrance.z() = sampler.sample(span.entrance.x(), span.entrance.y());
+                span.exit.z() = sampler.sample(span.exit.x(), span.exit.y());
+                span.chainageStart = interval.chainageStart;
+                span.chainageEnd = interval.chainageEnd;
+                tunnelSpans.push_back(span);
             }
         }
+        return;
     }
     
-    // 聚类分析高地区域（示例简化）
-    if(highGroundPoints.size() > 50) { // 阈值判断
-        tunnelEntrance = computeTunnelEntrance();
-        tunnelExit = computeTunnelExit();
+    // 走廊内连通区域标记，格点投影到线路，按起点桩号排序
+    std::vector<TerrainRegion> regions = labelTerrainRegions(terrain.get(),
+        [&](int, int, const osg::Vec3& vertex, float chainage) {
+            return vertex.z() > gradeline.elevation(chainage) + params.heightThreshold;
+        },
+        alignment, 0.5f * corridor.corridorWidth);
+    
+    // 每个足够大的高地区域对应一条隧道
+    for(const auto& region : regions) {
+        if(region.cellCount > 50) { // 阈值判断
+            TunnelSpan span;
+            span.entrance = computeTunnelEntrance(region);
+            span.exit = computeTunnelExit(region);
+            span.chainageStart = std::max(region.chainageMin, 0.0f);
+            span.chainageEnd = std::min(region.chainageMax, alignment.length());
+            tunnelSpans.push_back(span);
+        }
     }
 }
 
-// 步骤c: 计算隧道入口位置
-osg::Vec3 TunnelBuilder::computeTunnelEntrance() {
-    // 找到第一个高地点作为入口
-    for(const auto& pt : highGroundPoints) {
-        if(pt.z() > 55.0f + params.heightThreshold) {
-            return pt;
-        }
-    }
-    return osg::Vec3(20, 20, 60); // 默认值
+// 步骤c: 计算隧道入口位置（区域内沿线路最靠前的格点）
+osg::Vec3 TunnelBuilder::computeTunnelEntrance(const TerrainRegion& region) {
+    return region.first;
 }
 
-// 步骤c: 计算隧道出口位置
-osg::Vec3 TunnelBuilder::computeTunnelExit() {
-    // 找到最后一个高地点作为出口
-    for(auto it = highGroundPoints.rbegin(); it != highGroundPoints.rend(); ++it) {
-        if(it->z() > 55.0f + params.heightThreshold) {
-            return *it;
-        }
-    }
-    return osg::Vec3(80, 80, 60); // 默认值
+// 步骤c: 计算隧道出口位置（区域内沿线路最靠后的格点）
+osg::Vec3 TunnelBuilder::computeTunnelExit(const TerrainRegion& region) {
+    return region.last;
 }
 
 // 步骤d-e: 构建隧道几何体
 void TunnelBuilder::buildTunnelGeometry() {
-    // 计算隧道延伸方向
-    osg::Vec3 direction = tunnelExit - tunnelEntrance;
-    direction.normalize();
-    
-    // 计算起点和终点
-    osg::Vec3 start = tunnelEntrance - direction * params.extensionLength;
-    osg::Vec3 end = tunnelExit + direction * params.extensionLength;
-    
-    // 生成隧道网格
-    generateTunnelMesh(start, end);
+    for(auto& span : tunnelSpans) {
+        generateTunnelMesh(span);
+    }
 }
 
-// 生成隧道网格
-void TunnelBuilder::generateTunnelMesh(const osg::Vec3& start, const osg::Vec3& end) {
-    osg::Geometry* tunnelGeom = new osg::Geometry();
-    osg::Vec3Array* verts = new osg::Vec3Array();
-    osg::Vec3Array* norms = new osg::Vec3Array();
-    
-    // 计算隧道长度和分段数
-    float length = (end - start).length();
-    int segments = length / params.precision;
-    
-    // 生成圆柱体隧道
-    for(int i=0; i<=segments; ++i) {
-        float ratio = i/(float)segments;
-        osg::Vec3 pos = start + (end - start)*ratio;
-        
-        // 生成圆形截面
-        for(float angle=0; angle<2*M_PI; angle+=M_PI/8) {
-            float x = cos(angle) * params.tunnelRadius;
-            float y = sin(angle) * params.tunnelRadius;
-            verts->push_back(pos + osg::Vec3(x, y, 0));
-            norms->push_back(osg::Vec3(x, y, 0));
-        }
+// 生成隧道网格（断面沿平纵线形扫掠，轴线取设计坡度线高程）
+void TunnelBuilder::generateTunnelMesh(TunnelSpan& span) {
+    // 沿线路向两端延伸
+    float chainageStart = std::max(span.chainageStart - params.extensionLength, 0.0f);
+    float chainageEnd = std::min(span.chainageEnd + params.extensionLength, alignment.length());
+    
+    // 必须保留的桩号：两端、洞口与纵断面分段点；平面折点作为可合并的候选
+    std::vector<std::pair<float, bool>> stations;
+    stations.push_back({ chainageStart, true });
+    stations.push_back({ chainageEnd, true });
+    stations.push_back({ std::max(span.chainageStart, chainageStart), true });
+    stations.push_back({ std::min(span.chainageEnd, chainageEnd), true });
+    for(float s : gradeline.breakChainages()) {
+        if(s > chainageStart && s < chainageEnd) stations.push_back({ s, true });
+    }
+    for(float s : alignment.vertexChainages()) {
+        if(s > chainageStart && s < chainageEnd) stations.push_back({ s, false });
     }
+    std::sort(stations.begin(), stations.end());
     
-    // 创建索引
-    osg::DrawElementsUInt* indices = new osg::DrawElementsUInt(GL_QUADS);
-    for(int i=0; i<segments; ++i) {
-        for(int j=0; j<16; ++j) {
-            int next = (j+1)%16;
-            indices->push_back(i*16 + j);
-            indices->push_back(i*16 + next);
-            indices->push_back((i+1)*16 + next);
-            indices->push_back((i+1)*16 + j);
+    // 竖曲线内按弦高容差加密：抛物线弦高 k*h^2/8，转角 k*h，k 为坡度变化率
+    const float maxBend = sqrtf(2 * params.chordTolerance / params.tunnelRadius);
+    std::vector<float> chainages;
+    std::vector<bool> required;
+    for(size_t i=0; i<stations.size(); ++i) {
+        if(!chainages.empty() && stations[i].first - chainages.back() < 1e-4f) {
+            required.back() = required.back() || stations[i].second;
+            continue;
+        }
+        if(!chainages.empty()) {
+            float a = chainages.back();
+            float b = stations[i].first;
+            float k = fabs(gradeline.gradeChangeRate(0.5f * (a + b)));
+            if(k > 0) {
+                float h = std::max(std::min(sqrtf(8 * params.chordTolerance / k), maxBend / k), params.precision);
+                int steps = static_cast<int>(ceil((b - a) / h));
+                for(int n=1; n<steps; ++n) {
+                    chainages.push_back(a + (b - a) * n / steps);
+                    required.push_back(false);
+                }
+            }
         }
+        chainages.push_back(stations[i].first);
+        required.push_back(stations[i].second);
+    }
+    
+    // 候选中心线，按弦高容差合并为最少断面环
+    std::vector<float> elevations(chainages.size());
+    gradeline.evaluate(chainages.data(), elevations.data(), chainages.size());
+    std::vector<osg::Vec3> candidates(chainages.size());
+    for(size_t i=0; i<chainages.size(); ++i) {
+        candidates[i] = alignment.position(chainages[i]);
+        candidates[i].z() = elevations[i];
     }
+    span.centreline = simplifyCentreline(candidates, required, params.chordTolerance, params.tunnelRadius);
     
-    tunnelGeom->setVertexArray(verts);
-    tunnelGeom->setNormalArray(norms, osg::Array::BIND_PER_VERTEX);
-    tunnelGeom->addPrimitiveSet(indices);
+    osg::Geometry* tunnelGeom = sweepTunnelProfile(profile, span.centreline);
     applyTexture(tunnelGeom);
     
     osg::Geode* tunnelGeode = new osg::Geode();
@@ -154,67 +194,133 @@ void TunnelBuilder::generateTunnelMesh(const osg::Vec3& start, const osg::Vec3&
 
 // 地形修改
 void TunnelBuilder::modifyTerrain() {
-    // 在隧道路径上挖洞
-    osg::Vec3 direction = tunnelExit - tunnelEntrance;
-    direction.normalize();
-    float length = (tunnelExit - tunnelEntrance).length();
-    
-    for(float t=0; t<=length; t+=params.precision) {
-        osg::Vec3 pos = tunnelEntrance + direction*t;
-        carveTerrain(pos, params.tunnelRadius);
+    // 沿断面扫掠所用的同一条简化轴线逐段扫掠挖洞，高程取设计坡度线
+    for(const auto& span : tunnelSpans) {
+        for(size_t i=0; i+1<span.centreline.size(); ++i) {
+            carveSweep(span.centreline[i], span.centreline[i+1], params.tunnelRadius);
+        }
     }
+    
+    // 全部裁剪完成后统一提交一次
+    updateTerrainGeometry();
 }
 
-// 地形裁剪实现
-void TunnelBuilder::carveTerrain(const osg::Vec3& pos, float radius) {
-    int x = pos.x();
-    int y = pos.y();
-    
-    // 在半径范围内降低地形高度
-    for(int i=-radius; i<=radius; ++i) {
-        for(int j=-radius; j<=radius; ++j) {
-            if(i*i + j*j <= radius*radius) {
-                int xi = x + i;
-                int yj = y + j;
-                if(xi >=0 && xi < 100 && yj >=0 && yj < 100) {
-                    terrain.heightField->setHeight(xi, yj, pos.z() - 2.0f);
-                }
-            }
+// 胶囊体与水平格网行的交集区间[lo, hi]（格网坐标），为空时返回false
+static bool capsuleRowSpan(const osg::Vec2& a, const osg::Vec2& b, float r, float y, float& lo, float& hi) {
+    lo = FLT_MAX;
+    hi = -FLT_MAX;
+    
+    // 两端圆
+    const osg::Vec2 ends[2] = { a, b };
+    for(const auto& p : ends) {
+        float dy = y - p.y();
+        if(dy*dy <= r*r) {
+            float half = sqrtf(r*r - dy*dy);
+            lo = std::min(lo, p.x() - half);
+            hi = std::max(hi, p.x() + half);
         }
     }
     
-    // 更新地形几何体
-    terrain.vertices->clear();
-    for(int x=0; x<100; ++x) {
-        for(int y=0; y<100; ++y) {
-            terrain.vertices->push_back(osg::Vec3(x, y, terrain.heightField->getHeight(x, y)));
+    // 中间矩形带：0 <= t(x) <= 1 且 |垂距(x)| <= r，两者均为x的线性函数
+    osg::Vec2 d = b - a;
+    float len2 = d.length2();
+    if(len2 > 0) {
+        float len = sqrtf(len2);
+        float ey = y - a.y();
+        float sLo = -FLT_MAX, sHi = FLT_MAX;
+        auto clip = [&](float slope, float intercept, float minValue, float maxValue) {
+            // minValue <= slope*(x - a.x) + intercept <= maxValue
+            if(fabsf(slope) < 1e-12f) {
+                if(intercept < minValue || intercept > maxValue) sHi = -FLT_MAX;
+                return;
+            }
+            float x0 = a.x() + (minValue - intercept) / slope;
+            float x1 = a.x() + (maxValue - intercept) / slope;
+            sLo = std::max(sLo, std::min(x0, x1));
+            sHi = std::min(sHi, std::max(x0, x1));
+        };
+        clip(d.x() / len2, ey * d.y() / len2, 0.0f, 1.0f);
+        clip(-d.y() / len, ey * d.x() / len, -r, r);
+        if(sLo <= sHi) {
+            lo = std::min(lo, sLo);
+            hi = std::max(hi, sHi);
         }
     }
-    terrainGeode->removeDrawables(0, terrainGeode->getNumDrawables());
-    terrainGeode->addDrawable(createTerrainGeometry());
+    return lo <= hi;
 }
 
-// 创建地形几何体
-osg::Geometry* TunnelBuilder::createTerrainGeometry() {
-    osg::Geometry* geom = new osg::Geometry();
-    geom->setVertexArray(terrain.vertices);
-    geom->addPrimitiveSet(new osg::DrawArrays(GL_POINTS, 0, terrain.vertices->size()));
-    return geom;
+// 扫掠胶囊体裁剪：逐行求胶囊体覆盖区间，按到中线的有符号距离判定格点，行间并行
+// 覆盖格点的地面降至轴线高程，低于轴线的地面保持不变
+void TunnelBuilder::carveSweep(const osg::Vec3& start, const osg::Vec3& end, float radius) {
+    // 转换到格网坐标
+    const osg::Vec3& origin = terrain->getOrigin();
+    const float spacing = terrain->getSpacing();
+    const osg::Vec2 a((start.x() - origin.x()) / spacing, (start.y() - origin.y()) / spacing);
+    const osg::Vec2 b((end.x() - origin.x()) / spacing, (end.y() - origin.y()) / spacing);
+    const osg::Vec2 d = b - a;
+    const float len2 = d.length2();
+    const float cells = radius / spacing;
+    const int columns = terrain->getNumColumns();
+    const int rows = terrain->getNumRows();
+    
+    int y0 = std::max(0, static_cast<int>(ceilf(std::min(a.y(), b.y()) - cells)));
+    int y1 = std::min(rows - 1, static_cast<int>(floorf(std::max(a.y(), b.y()) + cells)));
+    if(y0 > y1) return;
+    
+    // 各行写入互不重叠的格点
+    std::vector<int> rowMin(y1 - y0 + 1, INT_MAX), rowMax(y1 - y0 + 1, INT_MIN);
+    parallelFor(y1 - y0 + 1, 0, [&](size_t row) {
+        const int yj = y0 + static_cast<int>(row);
+        float lo, hi;
+        if(!capsuleRowSpan(a, b, cells, static_cast<float>(yj), lo, hi)) return;
+        
+        int x0 = std::max(0, static_cast<int>(ceilf(lo)));
+        int x1 = std::min(columns - 1, static_cast<int>(floorf(hi)));
+        if(x0 > x1) return;
+        
+        // 整行区间一次读出，本地更新后只回写降低的格点
+        const size_t count = x1 - x0 + 1;
+        std::vector<int> xs(count), ys(count, yj);
+        std::vector<float> heights(count);
+        for(size_t i=0; i<count; ++i) xs[i] = x0 + static_cast<int>(i);
+        terrain->gatherHeights(xs.data(), ys.data(), heights.data(), count);
+        
+        size_t written = 0;
+        for(size_t i=0; i<count; ++i) {
+            // 有符号距离：格点到中线段的距离减去半径
+            const int xi = xs[i];
+            osg::Vec2 p(static_cast<float>(xi), static_cast<float>(yj));
+            float t = len2 > 0 ? osg::clampBetween(((p - a) * d) / len2, 0.0f, 1.0f) : 0.0f;
+            if((p - (a + d * t)).length() - cells > 0) continue;
+            
+            float z = start.z() + (end.z() - start.z()) * t;
+            if(heights[i] <= z) continue;
+            xs[written] = xi;
+            heights[written] = z;
+            ++written;
+            rowMin[row] = std::min(rowMin[row], xi);
+            rowMax[row] = std::max(rowMax[row], xi);
+        }
+        if(written) terrain->scatterHeights(xs.data(), ys.data(), heights.data(), written);
+    });
+    
+    for(size_t row=0; row<rowMin.size(); ++row) {
+        if(rowMin[row] <= rowMax[row]) {
+            int yj = y0 + static_cast<int>(row);
+            terrainDirty.expandBy(rowMin[row], yj, rowMax[row], yj);
+        }
+    }
 }
 
-// 应用纹理
-void TunnelBuilder::applyTexture(osg::Geometry* geom) {
-    osg::Texture2D* texture = new osg::Texture2D();
-    texture->setImage(osgDB::readImageFile("tunnel_texture.png"));
+// 提交脏区域内的顶点修改：只重读脏区域内的高程，只有相交的显示块重新上传
+void TunnelBuilder::updateTerrainGeometry() {
+    if(!terrainDirty.valid()) return;
     
-    osg::StateSet* stateset = geom->getOrCreateStateSet();
-    stateset->setTextureAttributeAndModes(0, texture, osg::StateAttribute::ON);
+    terrainDisplay.refresh(terrainDirty);
+    terrainDirty.reset();
 }
 
-// Qt主函数
-int main(int argc, char** argv) {
-    QApplication app(argc, argv);
-    TunnelBuilder window;
-    window.show();
-    return app.exec();
+// 应用纹理
+void TunnelBuilder::applyTexture(osg::Geometry* geom) {
+    geom->setStateSet(TextureCache::instance().getStateSet(MATERIAL_TUNNEL));
 }
\ No newline at end of file
@@ -1,8 +1,12 @@
 #pragma once
 #include <osg/Geode>
 #include <osg/Geometry>
-#include <osgViewer/Viewer>
-#include <QMainWindow>
+#include "Terrain.h"
+#include "TerrainDisplay.h"
+#include "RegionLabeling.h"
+#include "Alignment.h"
+#include "TunnelSweep.h"
+#include <algorithm>
 #include <vector>
 #include <cmath>
 
@@ -11,22 +15,37 @@ struct TunnelParameters {
     float entranceLength;    // 洞口长度
     float entranceWidth;     // 洞口宽度
     float tunnelRadius;      // 隧道半径
-    float precision;         // 插值精度
+    float precision;         // 插值精度（断面环最小间距）
     float heightThreshold;   // 高程阈值B
     float extensionLength;   // 延伸长度C
     int textureType;         // 纹理类型
+    
+    // 断面参数（追加在末尾，不改变既有字段顺序）
+    TunnelProfileShape profileShape; // 断面形状
+    int profileSegments;     // 断面一周分段数
+    float chordTolerance;    // 弦高容差（自适应布置断面环）
 };
 
-// 地形数据结构
-struct TerrainData {
-    osg::ref_ptr<osg::HeightField> heightField;
-    osg::Vec3Array* vertices;
+// 单条隧道的洞口位置
+struct TunnelSpan {
+    osg::Vec3 entrance;     // 入口
+    osg::Vec3 exit;         // 出口
+    float chainageStart;    // 入口桩号
+    float chainageEnd;      // 出口桩号
+    std::vector<osg::Vec3> centreline;  // 简化后的隧道轴线（断面扫掠与地形裁剪共用）
 };
 
-class TunnelBuilder : public QMainWindow {
-    Q_OBJECT
+// 隧道建模引擎（不依赖窗口，可在无显示环境下运行）
+class TunnelBuilder {
 public:
-    TunnelBuilder(QWidget* parent = nullptr);
+    explicit TunnelBuilder(Terrain* sharedTerrain = nullptr);
+    TunnelBuilder(const TunnelParameters& parameters, Terrain* sharedTerrain = nullptr);
+    osg::Group* getRoot() const { return root.get(); }
+    void setAlignment(const HorizontalAlignment& route) { alignment = route; }
+    void setGradeline(const VerticalAlignment& profile) { gradeline = profile; }
+    void setCorridor(const CorridorParameters& parameters) { corridor = parameters; }
+    void setDetectionMode(StructureDetectionMode mode) { detectionMode = mode; }
+    void run();
     void initializeScene();
     void computeHighGroundAreas();
     void buildTunnelGeometry();
@@ -34,22 +53,26 @@ public:
 
 private:
     // OSG场景组件
-    osg::ref_ptr<osgViewer::Viewer> viewer;
     osg::ref_ptr<osg::Group> root;
-    osg::ref_ptr<osg::Geode> terrainGeode;
+    TerrainDisplay terrainDisplay;                 // 线路走廊内的地形显示网格
     
     // 算法中间数据
     TunnelParameters params;
-    TerrainData terrain;
-    std::vector<osg::Vec3> highGroundPoints;
-    osg::Vec3 tunnelEntrance;
-    osg::Vec3 tunnelExit;
+    osg::ref_ptr<Terrain> terrain;                 // 共享地形上的写时复制覆盖层
+    TerrainDirtyRegion terrainDirty;
+    HorizontalAlignment alignment;
+    VerticalAlignment gradeline;                   // 设计坡度线
+    CorridorParameters corridor;
+    StructureDetectionMode detectionMode;
+    std::vector<TunnelSpan> tunnelSpans;
+    TunnelProfile profile;                         // 预计算的隧道断面
 
     // 辅助函数
     bool isHighGround(float x, float y);
-    osg::Vec3 computeTunnelEntrance();
-    osg::Vec3 computeTunnelExit();
-    void generateTunnelMesh(const osg::Vec3& start, const osg::Vec3& end);
+    osg::Vec3 computeTunnelEntrance(const TerrainRegion& region);
+    osg::Vec3 computeTunnelExit(const TerrainRegion& region);
+    void generateTunnelMesh(TunnelSpan& span);
     void applyTexture(osg::Geometry* geom);
-    void carveTerrain(const osg::Vec3& pos, float radius);
+    void carveSweep(const osg::Vec3& start, const osg::Vec3& end, float radius);
+    void updateTerrainGeometry();
 };
\ No newline at end of file
@@ -0,0 +1,191 @@
+#include "TunnelSweep.h"
+#include <osg/Math>
+#include <algorithm>
+#include <cmath>
+
+// 生成断面轮廓
+TunnelProfile TunnelProfile::create(TunnelProfileShape shape, float radius, int segments) {
+    TunnelProfile profile;
+    segments = std::max(segments, 8);
+    const float r = radius;
+    switch(shape) {
+        case PROFILE_HORSESHOE: {
+            // 圆拱自水平线下30°起，底部以平底封闭
+            const float floorAngle = osg::DegreesToRadians(30.0f);
+            const float floorY = -r * sinf(floorAngle);
+            const float floorX = r * cosf(floorAngle);
+            profile.addLine(osg::Vec2(0, floorY), osg::Vec2(floorX, floorY));
+            profile.addArc(osg::Vec2(0, 0), r, -floorAngle, osg::PI + floorAngle,
+                           static_cast<int>(segments * (osg::PI + 2 * floorAngle) / (2 * osg::PI)) + 1);
+            profile.addLine(osg::Vec2(-floorX, floorY), osg::Vec2(0, floorY));
+            break;
+        }
+        case PROFILE_ARCH: {
+            // 半圆拱 + 直墙，墙高取半径的0.6倍
+            const float wall = 0.6f * r;
+            profile.addLine(osg::Vec2(0, -wall), osg::Vec2(r, -wall));
+            profile.addLine(osg::Vec2(r, -wall), osg::Vec2(r, 0));
+            profile.addArc(osg::Vec2(0, 0), r, 0.0f, osg::PI, segments / 2);
+            profile.addLine(osg::Vec2(-r, 0), osg::Vec2(-r, -wall));
+            profile.addLine(osg::Vec2(-r, -wall), osg::Vec2(0, -wall));
+            break;
+        }
+        default:
+            // 自底部起逆时针一周
+            profile.addArc(osg::Vec2(0, 0), r, -osg::PI_2, 1.5f * osg::PI, segments);
+            break;
+    }
+    profile.finish();
+    return profile;
+}
+
+// 圆弧（逆时针，含两端点），法线指向圆心
+void TunnelProfile::addArc(const osg::Vec2& centre, float radius, float angleStart, float angleEnd, int segments) {
+    segments = std::max(segments, 2);
+    for(int i=0; i<=segments; ++i) {
+        float angle = angleStart + (angleEnd - angleStart) * i / segments;
+        osg::Vec2 dir(cosf(angle), sinf(angle));
+        points.push_back(centre + dir * radius);
+        normals.push_back(-dir);
+    }
+}
+
+// 直线段（含两端点），逆时针轮廓的内侧为前进方向左侧
+void TunnelProfile::addLine(const osg::Vec2& a, const osg::Vec2& b) {
+    osg::Vec2 d = b - a;
+    d.normalize();
+    points.push_back(a);
+    points.push_back(b);
+    normals.push_back(osg::Vec2(-d.y(), d.x()));
+    normals.push_back(osg::Vec2(-d.y(), d.x()));
+}
+
+// 计算沿轮廓的纹理坐标
+void TunnelProfile::finish() {
+    texCoords.resize(points.size());
+    length = 0.0f;
+    for(size_t i=0; i<points.size(); ++i) {
+        if(i > 0) length += (points[i] - points[i-1]).length();
+        texCoords[i] = length;
+    }
+    for(auto& u : texCoords) {
+        u = length > 0 ? u / length : 0.0f;
+    }
+}
+
+// 将向量v按把单位向量a转到单位向量b的最小旋转进行旋转
+static osg::Vec3 rotateBetween(const osg::Vec3& v, const osg::Vec3& a, const osg::Vec3& b) {
+    osg::Vec3 axis = a ^ b;
+    float s = axis.length();
+    float c = a * b;
+    if(s < 1e-6f) return v;
+    axis /= s;
+    return v * c + (axis ^ v) * s + axis * ((axis * v) * (1 - c));
+}
+
+osg::Geometry* sweepTunnelProfile(const TunnelProfile& profile, const std::vector<osg::Vec3>& centreline) {
+    osg::Geometry* geom = new osg::Geometry();
+    const size_t rings = centreline.size();
+    const size_t ringSize = profile.size();
+    if(rings < 2 || ringSize < 2) return geom;
+
+    osg::Vec3Array* verts = new osg::Vec3Array();
+    osg::Vec3Array* norms = new osg::Vec3Array();
+    osg::Vec2Array* texCoords = new osg::Vec2Array();
+    verts->reserve(rings * ringSize);
+    norms->reserve(rings * ringSize);
+    texCoords->reserve(rings * ringSize);
+
+    const std::vector<osg::Vec2>& points = profile.getPoints();
+    const std::vector<osg::Vec2>& normals = profile.getNormals();
+    const std::vector<float>& us = profile.getTexCoords();
+
+    // 初始标架：上方向取世界Z轴在首个法平面内的投影
+    osg::Vec3 tangent = centreline[1] - centreline[0];
+    tangent.normalize();
+    osg::Vec3 up = osg::Vec3(0, 0, 1) - tangent * tangent.z();
+    if(up.normalize() < 1e-6f) up = osg::Vec3(0, 1, 0);
+
+    float distance = 0.0f;
+    for(size_t i=0; i<rings; ++i) {
+        // 中心差分切向，沿线平行移动上方向
+        osg::Vec3 next = centreline[std::min(i + 1, rings - 1)] - centreline[i > 0 ? i - 1 : 0];
+        next.normalize();
+        up = rotateBetween(up, tangent, next);
+        up = up - next * (up * next);
+        up.normalize();
+        tangent = next;
+        osg::Vec3 left = up ^ tangent;
+        if(i > 0) distance += (centreline[i] - centreline[i-1]).length();
+
+        for(size_t k=0; k<ringSize; ++k) {
+            verts->push_back(centreline[i] + left * points[k].x() + up * points[k].y());
+            norms->push_back(left * normals[k].x() + up * normals[k].y());
+            texCoords->push_back(osg::Vec2(us[k], distance / profile.perimeter()));
+        }
+    }
+
+    // 每个环段一段三角带，段间重复首尾索引形成退化三角形，保持奇偶不变
+    osg::DrawElementsUInt* strip = new osg::DrawElementsUInt(GL_TRIANGLE_STRIP);
+    strip->reserve((rings - 1) * (ringSize * 2 + 2));
+    for(size_t i=0; i+1<rings; ++i) {
+        unsigned int a = i * ringSize;
+        unsigned int b = a + ringSize;
+        if(i > 0) {
+            strip->push_back(strip->back());
+            strip->push_back(a);
+        }
+        for(size_t k=0; k<ringSize; ++k) {
+            strip->push_back(a + k);
+            strip->push_back(b + k);
+        }
+    }
+
+    geom->setVertexArray(verts);
+    geom->setNormalArray(norms, osg::Array::BIND_PER_VERTEX);
+    geom->setTexCoordArray(0, texCoords);
+    geom->addPrimitiveSet(strip);
+    return geom;
+}
+
+// 点到线段的距离
+static float distanceToSegment(const osg::Vec3& p, const osg::Vec3& a, const osg::Vec3& b) {
+    osg::Vec3 ab = b - a;
+    float len2 = ab.length2();
+    float t = len2 > 0 ? osg::clampBetween(((p - a) * ab) / len2, 0.0f, 1.0f) : 0.0f;
+    return (a + ab * t - p).length();
+}
+
+std::vector<osg::Vec3> simplifyCentreline(const std::vector<osg::Vec3>& candidates, const std::vector<bool>& required,
+                                          float chordTolerance, float profileRadius) {
+    const size_t count = candidates.size();
+    if(count < 3) return candidates;
+    
+    // 断面环转过角度θ时洞壁偏差约为 r*θ^2/2
+    const float maxBend = profileRadius > 0 ? sqrtf(2 * chordTolerance / profileRadius) : osg::PI;
+    const float cosMaxBend = cosf(std::min(maxBend, static_cast<float>(osg::PI)));
+    const size_t maxLookahead = 256; // 限制单步向前搜索范围，保证线性复杂度
+    
+    std::vector<osg::Vec3> kept;
+    kept.push_back(candidates[0]);
+    size_t anchor = 0;
+    while(anchor + 1 < count) {
+        // 贪心向前延伸，直到下一个点违反容差或遇到必须保留的点
+        size_t best = anchor + 1;
+        for(size_t j = anchor + 2; j < count && j - anchor <= maxLookahead && !required[best]; ++j) {
+            osg::Vec3 chord = candidates[j] - candidates[anchor];
+            if(chord.normalize() <= 0) break;
+            bool ok = true;
+            for(size_t k = anchor + 1; k < j && ok; ++k) {
+                osg::Vec3 step = candidates[k+1] - candidates[k];
+                ok = distanceToSegment(candidates[k], candidates[anchor], candidates[j]) <= chordTolerance &&
+                     (step.normalize() <= 0 || step * chord >= cosMaxBend);
+            }
+            if(!ok) break;
+            best = j;
+        }
+        kept.push_back(candidates[best]);
+        anchor = best;
+    }
+    return kept;
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+#include <osg/Geometry>
+#include <osg/Vec2>
+#include <osg/Vec3>
+#include <vector>
+
+// 隧道断面形状
+enum TunnelProfileShape {
+    PROFILE_CIRCLE = 0,     // 圆形
+    PROFILE_HORSESHOE,      // 马蹄形：圆拱 + 平底
+    PROFILE_ARCH            // 直墙拱形：半圆拱 + 直墙 + 平底
+};
+
+// 隧道断面：闭合轮廓，逆时针排列，只计算一次供所有断面环复用
+// 局部坐标 x 向左、y 向上，原点位于隧道轴线；折角处顶点重复以保持硬边法线，法线指向隧道内部
+class TunnelProfile {
+public:
+    TunnelProfile() : length(0.0f) {}
+    static TunnelProfile create(TunnelProfileShape shape, float radius, int segments);
+
+    size_t size() const { return points.size(); }
+    float perimeter() const { return length; }
+    const std::vector<osg::Vec2>& getPoints() const { return points; }
+    const std::vector<osg::Vec2>& getNormals() const { return normals; }
+    const std::vector<float>& getTexCoords() const { return texCoords; }
+
+private:
+    void addArc(const osg::Vec2& centre, float radius, float angleStart, float angleEnd, int segments);
+    void addLine(const osg::Vec2& a, const osg::Vec2& b);
+    void finish();
+
+    std::vector<osg::Vec2> points;     // 轮廓点（首尾重合）
+    std::vector<osg::Vec2> normals;    // 内法线
+    std::vector<float> texCoords;      // 沿轮廓归一化弧长
+    float length;                      // 轮廓周长
+};
+
+// 沿中心线扫掠断面：断面环由平行移动标架定向，在弯曲与变坡线形上不产生扭转
+// 输出单条带索引的三角带（相邻环段之间以退化三角形连接），顶点缓冲按环数预留
+osg::Geometry* sweepTunnelProfile(const TunnelProfile& profile, const std::vector<osg::Vec3>& centreline);
+
+// 自适应断面环布置：从候选中心线点中保留满足弦高容差所需的最少点
+// 被跳过的点到弦线的距离不超过容差，且相邻保留环之间的弯折使洞壁偏差不超过容差；
+// required 标记的点（线形变化点、洞口）始终保留
+std::vector<osg::Vec3> simplifyCentreline(const std::vector<osg::Vec3>& candidates, const std::vector<bool>& required,
+                                          float chordTolerance, float profileRadius);
\ No newline at end of file
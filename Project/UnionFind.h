@@ -0,0 +1,31 @@
+#pragma once
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+// 并查集（根取集合中最小的编号）
+class UnionFind {
+public:
+    explicit UnionFind(size_t n) : parent(n) {
+        std::iota(parent.begin(), parent.end(), 0);
+    }
+    int add() {
+        parent.push_back(static_cast<int>(parent.size()));
+        return parent.back();
+    }
+    int find(int i) {
+        while(parent[i] != i) {
+            parent[i] = parent[parent[i]];
+            i = parent[i];
+        }
+        return i;
+    }
+    void unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if(a != b) parent[std::max(a, b)] = std::min(a, b);
+    }
+
+private:
+    std::vector<int> parent;
+};
\ No newline at end of file